@@ -0,0 +1,255 @@
+/**
+ * Parser micro-benchmarks.
+ *
+ * Usage: bench [<filter>] [<seconds-per-case>]
+ *
+ * Runs each case that contains <filter> in its name for at least the given time (0.25 seconds by
+ * default), and prints its throughput. Cases that read from a buffer_source run twice: once from a
+ * contiguous buffer, and once through a pathological_buffer_range that hands out one byte at a
+ * time. Cycles are counted with the time-stamp counter where one is available.
+ */
+
+#include <neo/http/parse/chunked.hpp>
+#include <neo/http/parse/request.hpp>
+#include <neo/http/parse/response.hpp>
+#include <neo/http/request.hpp>
+#include <neo/http/response.hpp>
+
+#include <neo/buffer_source.hpp>
+#include <neo/pathological_buffer_range.hpp>
+#include <neo/string_io.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define NEO_HTTP_BENCH_HAVE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define NEO_HTTP_BENCH_HAVE_TSC 1
+#endif
+
+using namespace neo;
+using namespace std::string_literals;
+
+namespace {
+
+std::uint64_t read_cycles() noexcept {
+#if defined(NEO_HTTP_BENCH_HAVE_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/// Keep the optimizer from discarding the results of the benchmarked code
+volatile std::size_t benchmark_sink = 0;
+
+void keep(std::size_t n) noexcept { benchmark_sink = benchmark_sink + n; }
+
+/// Messages that look like those seen in the wild
+namespace corpus {
+
+const std::string tiny_get = "GET / HTTP/1.1\r\nHost: example.com\r\n\r\n";
+
+const std::string browser_get = [] {
+    std::string cookie;
+    for (int n = 0; cookie.size() < 2048; ++n) {
+        cookie += "session_" + std::to_string(n) + "=" + std::string(24, char('a' + n % 26)) + "; ";
+    }
+    return "GET /static/js/app.4f1c2b.js?v=1622 HTTP/1.1\r\n"
+           "Host: www.example.com\r\n"
+           "Connection: keep-alive\r\n"
+           "sec-ch-ua: \" Not A;Brand\";v=\"99\", \"Chromium\";v=\"90\"\r\n"
+           "sec-ch-ua-mobile: ?0\r\n"
+           "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+           "Chrome/90.0.4430.93 Safari/537.36\r\n"
+           "Accept: */*\r\n"
+           "Sec-Fetch-Site: same-origin\r\n"
+           "Sec-Fetch-Mode: no-cors\r\n"
+           "Sec-Fetch-Dest: script\r\n"
+           "Referer: https://www.example.com/account/settings\r\n"
+           "Accept-Encoding: gzip, deflate, br\r\n"
+           "Accept-Language: en-US,en;q=0.9\r\n"
+           "Cookie: "
+        + cookie
+        + "\r\n"
+          "\r\n";
+}();
+
+const std::string api_response = "HTTP/1.1 200 OK\r\n"
+                                 "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+                                 "Content-Type: application/json; charset=utf-8\r\n"
+                                 "Content-Length: 1432\r\n"
+                                 "Connection: keep-alive\r\n"
+                                 "Cache-Control: private, max-age=0, no-cache\r\n"
+                                 "ETag: W/\"598-8YBl0AqJcQ2Y0Wc0hXjvXQ\"\r\n"
+                                 "Vary: Accept-Encoding, Origin\r\n"
+                                 "X-Request-Id: 5d1c9a7e-3f0b-4a8e-9d62-0e1f3c7b2a4d\r\n"
+                                 "Strict-Transport-Security: max-age=31536000\r\n"
+                                 "Access-Control-Allow-Origin: *\r\n"
+                                 "\r\n";
+
+/// A body made of many 100 to 500 byte chunks, as from a server streaming events
+const std::string small_chunks = [] {
+    std::string ret;
+    for (int n = 0; ret.size() < 64 * 1024; ++n) {
+        auto size = static_cast<std::size_t>(100 + (n * 37) % 400);
+        char hex[16];
+        auto len = std::snprintf(hex, sizeof hex, "%zx", size);
+        ret.append(hex, static_cast<std::size_t>(len)).append("\r\n");
+        ret.append(size, char('a' + n % 26)).append("\r\n");
+    }
+    return ret + "0\r\n\r\n";
+}();
+
+}  // namespace corpus
+
+struct bench_case {
+    std::string                  name;
+    std::size_t                  bytes_per_message;
+    std::function<std::size_t()> run_once;
+};
+
+void run_case(const bench_case& bc, double min_seconds) {
+    using clock = std::chrono::steady_clock;
+    std::size_t n_runs = 0;
+    std::size_t batch  = 1;
+
+    auto start        = clock::now();
+    auto start_cycles = read_cycles();
+    auto elapsed      = clock::duration::zero();
+    while (std::chrono::duration<double>(elapsed).count() < min_seconds) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            keep(bc.run_once());
+        }
+        n_runs += batch;
+        batch *= 2;
+        elapsed = clock::now() - start;
+    }
+    auto cycles  = read_cycles() - start_cycles;
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    auto bytes   = static_cast<double>(n_runs) * static_cast<double>(bc.bytes_per_message);
+
+    std::printf("%-44s %10.1f MB/s %12.0f msg/s",
+                bc.name.c_str(),
+                bytes / seconds / 1e6,
+                static_cast<double>(n_runs) / seconds);
+    if (cycles != 0) {
+        std::printf(" %8.2f cycles/B", static_cast<double>(cycles) / bytes);
+    }
+    std::printf("\n");
+}
+
+std::vector<bench_case> all_cases() {
+    std::vector<bench_case> cases;
+
+    // Add a case that processes `bytes` bytes of `msg` on each run
+    auto add_sized = [&](std::string name, std::size_t bytes, const std::string& msg, auto fn) {
+        cases.push_back({std::move(name), bytes, [&msg, fn] { return fn(msg); }});
+    };
+    auto add = [&](std::string name, const std::string& msg, auto fn) {
+        add_sized(std::move(name), msg.size(), msg, fn);
+    };
+
+    // Cases that parse a buffer that already holds the entire message
+    for (auto [label, msg] : {std::pair{"tiny-get", &corpus::tiny_get},
+                              std::pair{"browser-get", &corpus::browser_get}}) {
+        // Only the start line is parsed, so only its bytes count
+        auto line_size = msg->size()
+            - http::request_line::parse(const_buffer(*msg)).parse_tail.size();
+        add_sized("request_line::parse/"s + label, line_size, *msg, [](const std::string& m) {
+            return http::request_line::parse(const_buffer(m)).method_view.size();
+        });
+        add("request_head::parse/"s + label, *msg, [](const std::string& m) {
+            return http::request_head::parse(const_buffer(m)).parse_tail.size();
+        });
+        add("header_iterator/"s + label, *msg, [](const std::string& m) {
+            auto        head = http::request_head::parse(const_buffer(m));
+            std::size_t n    = 0;
+            for (auto& field : head.headers.iter_headers()) {
+                n += field.value_view.size();
+            }
+            return n;
+        });
+    }
+    add("response_head::parse/api-response", corpus::api_response, [](const std::string& m) {
+        return http::response_head::parse(const_buffer(m)).parse_tail.size();
+    });
+
+    // Cases that pull from a buffer_source, both contiguous and fragmented
+    add("read_response_head/api-response/contiguous",
+        corpus::api_response,
+        [](const std::string& m) {
+            return http::read_response_head<http::simple_response>(const_buffer(m))
+                .head_byte_size;
+        });
+    add("read_response_head/api-response/fragmented",
+        corpus::api_response,
+        [](const std::string& m) {
+            return http::read_response_head<http::simple_response>(
+                       pathological_buffer_range(const_buffer(m)))
+                .head_byte_size;
+        });
+    add("read_request_head/browser-get/contiguous",
+        corpus::browser_get,
+        [](const std::string& m) {
+            return http::read_request_head<http::simple_request>(const_buffer(m)).head_byte_size;
+        });
+    add("read_request_head/browser-get/fragmented",
+        corpus::browser_get,
+        [](const std::string& m) {
+            return http::read_request_head<http::simple_request>(
+                       pathological_buffer_range(const_buffer(m)))
+                .head_byte_size;
+        });
+
+    auto decode = [](auto&& chunks) {
+        string_dynbuf_io out;
+        return buffer_copy(out, chunks);
+    };
+    add("chunked_buffers/small-chunks/contiguous",
+        corpus::small_chunks,
+        [decode](const std::string& m) {
+            return decode(http::chunked_buffers{buffers_consumer{const_buffer(m)}});
+        });
+    add("chunked_buffers/small-chunks/fragmented",
+        corpus::small_chunks,
+        [decode](const std::string& m) {
+            pathological_buffer_range rng{const_buffer(m)};
+            return decode(http::chunked_buffers{buffers_consumer{rng}});
+        });
+    add("chunked_span_buffers/small-chunks/contiguous",
+        corpus::small_chunks,
+        [decode](const std::string& m) {
+            return decode(http::chunked_span_buffers{buffers_consumer{const_buffer(m)}});
+        });
+    add("chunked_span_buffers/small-chunks/fragmented",
+        corpus::small_chunks,
+        [decode](const std::string& m) {
+            pathological_buffer_range rng{const_buffer(m)};
+            return decode(http::chunked_span_buffers{buffers_consumer{rng}});
+        });
+    return cases;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string_view filter      = argc > 1 ? argv[1] : "";
+    double           min_seconds = argc > 2 ? std::atof(argv[2]) : 0.25;
+
+    for (auto& bc : all_cases()) {
+        if (bc.name.find(filter) != std::string::npos) {
+            run_case(bc, min_seconds);
+        }
+    }
+    return static_cast<int>(benchmark_sink & 0);
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "./parse/chunked.hpp"
+#include "./parse/framing.hpp"
+
+#include <neo/assert.hpp>
+#include <neo/buffer_source.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace neo::http {
+
+/**
+ * A buffer_source for the body of a message that was read from `In`, framed by the message's
+ * Content-Length or chunked Transfer-Encoding, or running until the end of the input.
+ *
+ * The buffers returned by next() are the buffers of the input, so if the input is contiguous the
+ * body can be forwarded without being copied. Chunked data is decoded, but any other
+ * transfer-coding is left in place.
+ *
+ * A body_source refers to its input, which must outlive it.
+ */
+template <buffer_source In>
+class body_source {
+public:
+    enum class kind_t {
+        /// There is no body
+        empty,
+        /// The body has a known length
+        length,
+        /// The body uses the chunked transfer-coding
+        chunked,
+        /// The body runs until the end of the input
+        until_close,
+    };
+
+    using next_type = decltype(std::declval<In&>().next(std::size_t(1)));
+
+private:
+    In*                                 _in        = nullptr;
+    kind_t                              _kind      = kind_t::empty;
+    std::uint64_t                       _remaining = 0;
+    std::optional<chunked_buffers<In&>> _chunked;
+
+    body_source(In& in, kind_t kind, std::uint64_t length = 0)
+        : _in(&in)
+        , _kind(kind)
+        , _remaining(length) {
+        if (kind == kind_t::chunked) {
+            _chunked.emplace(in);
+        }
+    }
+
+public:
+    /// The body of a response with the given status to a request that was not HEAD (RFC 7230 3.3.3)
+    static body_source for_response(In& in, const message_framing& framing, int status) {
+        if (status < 200 || status == 204 || status == 304) {
+            return body_source(in, kind_t::empty);
+        } else if (framing.has_transfer_encoding()) {
+            // If chunked is not the final coding, the body runs until the connection closes
+            return body_source(in, framing.chunked ? kind_t::chunked : kind_t::until_close);
+        } else if (framing.has_content_length) {
+            return body_source(in, kind_t::length, framing.content_length);
+        }
+        return body_source(in, kind_t::until_close);
+    }
+
+    /// The body of a request (RFC 7230 3.3.3)
+    static body_source for_request(In& in, const message_framing& framing) {
+        if (framing.has_transfer_encoding()) {
+            if (!framing.chunked) {
+                throw std::runtime_error(
+                    "HTTP request has a Transfer-Encoding that does not end with 'chunked'");
+            }
+            return body_source(in, kind_t::chunked);
+        } else if (framing.has_content_length) {
+            return body_source(in, kind_t::length, framing.content_length);
+        }
+        return body_source(in, kind_t::empty);
+    }
+
+    constexpr kind_t kind() const noexcept { return _kind; }
+
+    /// The input that the body is read from
+    In& next_layer() const noexcept { return *_in; }
+
+    /// Whether the entire body has been consumed. A body that runs until close is never done.
+    bool done() const noexcept {
+        switch (_kind) {
+        case kind_t::empty:
+            return true;
+        case kind_t::length:
+            return _remaining == 0;
+        case kind_t::chunked:
+            return _chunked->done();
+        case kind_t::until_close:
+            break;
+        }
+        return false;
+    }
+
+    /// The number of bytes of the body that have not been consumed, if the body has a length
+    std::optional<std::uint64_t> remaining() const noexcept {
+        if (_kind == kind_t::length) {
+            return _remaining;
+        } else if (_kind == kind_t::empty) {
+            return 0;
+        }
+        return std::nullopt;
+    }
+
+    /// The chunked decoder, for access to the trailer fields. Only for a chunked body.
+    const chunked_buffers<In&>& chunked() const noexcept {
+        neo_assert(expects, _kind == kind_t::chunked, "Message body is not chunked");
+        return *_chunked;
+    }
+
+    /**
+     * Record that `n` bytes of the body were taken from the input by something other than
+     * next() and consume(), such as a splice(). Only for a body of known length, or one that runs
+     * until close.
+     */
+    void mark_transferred(std::uint64_t n) noexcept {
+        neo_assert(expects,
+                   _kind == kind_t::length || _kind == kind_t::until_close,
+                   "Only a body that is not chunked can be transferred around its body_source");
+        if (_kind == kind_t::length) {
+            neo_assert(expects,
+                       n <= _remaining,
+                       "Cannot transfer more bytes than remain in a message body",
+                       n,
+                       _remaining);
+            _remaining -= n;
+        }
+    }
+
+    next_type next(std::size_t n) {
+        switch (_kind) {
+        case kind_t::empty:
+            break;
+        case kind_t::length:
+            if (_remaining < n) {
+                n = static_cast<std::size_t>(_remaining);
+            }
+            return _in->next(n);
+        case kind_t::chunked:
+            return _chunked->next(n);
+        case kind_t::until_close:
+            return _in->next(n);
+        }
+        return _in->next(0);
+    }
+
+    void consume(std::size_t n) {
+        switch (_kind) {
+        case kind_t::empty:
+            neo_assert(expects, n == 0, "Cannot consume bytes from an empty message body", n);
+            break;
+        case kind_t::length:
+            neo_assert(expects,
+                       n <= _remaining,
+                       "Cannot consume more bytes than remain in a message body",
+                       n,
+                       _remaining);
+            _remaining -= n;
+            _in->consume(n);
+            break;
+        case kind_t::chunked:
+            _chunked->consume(n);
+            break;
+        case kind_t::until_close:
+            _in->consume(n);
+            break;
+        }
+    }
+};
+
+}  // namespace neo::http
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <neo/http/parse/header.hpp>
+#include <neo/http/parse/response.hpp>
+#include <neo/http/version.hpp>
+
+#include <neo/assert.hpp>
+#include <neo/buffer_algorithm/copy.hpp>
+#include <neo/const_buffer.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace neo::http {
+
+/**
+ * A response head whose status phrase and header fields are views into a single buffer holding
+ * the raw bytes of the head.
+ *
+ * The buffer is either one reference-counted allocation owned by the response (see copy_of()),
+ * or storage owned by the caller (see borrow()). Copies of an owning response share the buffer,
+ * so a response can be handed to another thread without copying any strings.
+ */
+class borrowed_response {
+    /// A reference-counted block of bytes, allocated along with its count
+    class shared_bytes {
+        struct block {
+            std::atomic<std::size_t> refs;
+            std::size_t              size;
+
+            std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+        };
+
+        block* _block = nullptr;
+
+        void _release() noexcept {
+            if (_block && _block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                _block->~block();
+                ::operator delete(_block);
+            }
+            _block = nullptr;
+        }
+
+    public:
+        shared_bytes() = default;
+
+        static shared_bytes copy_of(const_buffer buf) {
+            shared_bytes ret;
+            ret._block = new (::operator new(sizeof(block) + buf.size())) block{{1}, buf.size()};
+            buffer_copy(mutable_buffer(ret._block->data(), buf.size()), buf);
+            return ret;
+        }
+
+        shared_bytes(const shared_bytes& other) noexcept
+            : _block(other._block) {
+            if (_block) {
+                _block->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        shared_bytes(shared_bytes&& other) noexcept
+            : _block(std::exchange(other._block, nullptr)) {}
+
+        shared_bytes& operator=(shared_bytes other) noexcept {
+            std::swap(_block, other._block);
+            return *this;
+        }
+
+        ~shared_bytes() { _release(); }
+
+        const_buffer bytes() const noexcept {
+            return _block ? const_buffer(_block->data(), _block->size) : const_buffer();
+        }
+    };
+
+    shared_bytes _owned;
+    const_buffer _head_bytes;
+    const_buffer _header_lines;
+
+    void _rebase(const response_head& head, const_buffer src, const_buffer dest) noexcept {
+        auto rebase = [&](const_buffer part) {
+            return dest.first(static_cast<std::size_t>(part.data_end() - src.data()))
+                + static_cast<std::size_t>(part.data() - src.data());
+        };
+        _head_bytes    = dest;
+        _header_lines  = rebase(head.headers.buffer);
+        version        = head.start_line.http_version;
+        status         = head.start_line.status;
+        status_message = std::string_view(rebase(const_buffer(head.start_line.phrase_view)));
+        head_byte_size = src.size();
+    }
+
+public:
+    int              status = 0;
+    std::string_view status_message;
+    http::version    version = http::version::invalid;
+
+    std::size_t head_byte_size = 0;
+
+    borrowed_response() = default;
+
+    /**
+     * Create a response that refers to a parsed head in `head_bytes`. The caller must keep
+     * `head_bytes` alive and unmodified for as long as the response is in use.
+     */
+    static borrowed_response borrow(const response_head& head, const_buffer head_bytes) noexcept {
+        return borrow(head, head_bytes, head_bytes);
+    }
+
+    /**
+     * Create a response that refers to `copy`, which holds the same bytes as the `head_bytes`
+     * that `head` was parsed from.
+     */
+    static borrowed_response
+    borrow(const response_head& head, const_buffer head_bytes, const_buffer copy) noexcept {
+        neo_assert(expects,
+                   copy.size() == head_bytes.size(),
+                   "borrowed_response::borrow() requires an exact copy of the head",
+                   copy.size(),
+                   head_bytes.size());
+        borrowed_response ret;
+        ret._rebase(head, head_bytes, copy);
+        return ret;
+    }
+
+    /// Create a response that owns a copy of `head_bytes`. This makes exactly one allocation.
+    static borrowed_response copy_of(const response_head& head, const_buffer head_bytes) {
+        borrowed_response ret;
+        ret._owned = shared_bytes::copy_of(head_bytes);
+        ret._rebase(head, head_bytes, ret._owned.bytes());
+        return ret;
+    }
+
+    /// Hook for read_response_head(): Take an owning copy of the head
+    void assign_head(const response_head& head, const_buffer head_bytes) {
+        *this = copy_of(head, head_bytes);
+    }
+
+    /// Whether this response shares ownership of its head bytes
+    bool owns_buffer() const noexcept { return _owned.bytes().data() != nullptr; }
+
+    /// The raw bytes of the response head, including the final CRLFCRLF
+    const_buffer head_bytes() const noexcept { return _head_bytes; }
+
+    auto headers() const noexcept {
+        return header_lines_buf{_header_lines, _head_bytes + _head_bytes.size()}.iter_headers();
+    }
+
+    std::optional<header_bufs> find_header(header_id id) const noexcept {
+        for (auto header : headers()) {
+            if (header.id == id) {
+                return header;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<header_bufs> find_header(std::string_view key) const noexcept {
+        if (auto id = classify_header(key); id != header_id::unknown) {
+            return find_header(id);
+        }
+        for (auto header : headers()) {
+            if (header.id == header_id::unknown && header.key_equivalent(key)) {
+                return header;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+}  // namespace neo::http
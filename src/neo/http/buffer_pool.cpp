@@ -0,0 +1,119 @@
+#include "./buffer_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <new>
+
+using namespace neo;
+using namespace neo::http;
+
+namespace {
+
+constexpr std::size_t size_class(std::size_t size) noexcept {
+    std::size_t cls = 0;
+    while ((min_pooled_buffer_size << cls) < size) {
+        ++cls;
+    }
+    return cls;
+}
+
+constexpr std::size_t n_size_classes = size_class(max_pooled_buffer_size) + 1;
+
+static_assert(size_class(1) == 0);
+static_assert(size_class(min_pooled_buffer_size) == 0);
+static_assert(size_class(min_pooled_buffer_size + 1) == 1);
+
+/// A free buffer. The link is stored in the buffer itself.
+struct free_block {
+    free_block* next;
+};
+
+static_assert(sizeof(free_block) <= min_pooled_buffer_size);
+
+struct thread_pool {
+    std::array<free_block*, n_size_classes> heads  = {};
+    std::array<std::size_t, n_size_classes> counts = {};
+
+    void trim() noexcept {
+        for (auto cls = 0u; cls < n_size_classes; ++cls) {
+            while (auto blk = heads[cls]) {
+                heads[cls] = blk->next;
+                ::operator delete(static_cast<void*>(blk));
+            }
+            counts[cls] = 0;
+        }
+    }
+
+    ~thread_pool();
+};
+
+// Whether this thread's pool has been destroyed. Being trivially destructible, this can still be
+// read from thread_local destructors that run after the pool's.
+thread_local bool tl_pool_destroyed = false;
+
+thread_pool::~thread_pool() {
+    trim();
+    tl_pool_destroyed = true;
+}
+
+thread_pool* this_thread_pool() noexcept {
+    if (tl_pool_destroyed) {
+        return nullptr;
+    }
+    thread_local thread_pool pool;
+    return &pool;
+}
+
+}  // namespace
+
+void http::pooled_buffer::reset() noexcept {
+    if (!_data) {
+        return;
+    }
+    auto data = std::exchange(_data, nullptr);
+    auto size = std::exchange(_size, 0);
+    auto pool = this_thread_pool();
+    auto cls  = size_class((std::min)(size, max_pooled_buffer_size));
+    if (!pool || size > max_pooled_buffer_size
+        || pool->counts[cls] == max_pooled_buffers_per_size) {
+        // Not ours to keep, or we already have enough of this size
+        ::operator delete(static_cast<void*>(data));
+        return;
+    }
+    auto blk         = ::new (static_cast<void*>(data)) free_block{pool->heads[cls]};
+    pool->heads[cls] = blk;
+    ++pool->counts[cls];
+}
+
+pooled_buffer http::acquire_buffer(std::size_t min_size) {
+    if (min_size > max_pooled_buffer_size) {
+        // Too large to pool
+        return pooled_buffer(static_cast<std::byte*>(::operator new(min_size)), min_size);
+    }
+    auto cls  = size_class(min_size);
+    auto size = min_pooled_buffer_size << cls;
+    auto pool = this_thread_pool();
+    if (pool && pool->heads[cls]) {
+        auto blk         = pool->heads[cls];
+        pool->heads[cls] = blk->next;
+        --pool->counts[cls];
+        blk->~free_block();
+        return pooled_buffer(reinterpret_cast<std::byte*>(blk), size);
+    }
+    return pooled_buffer(static_cast<std::byte*>(::operator new(size)), size);
+}
+
+void http::trim_buffer_pool() noexcept {
+    if (auto pool = this_thread_pool()) {
+        pool->trim();
+    }
+}
+
+std::size_t http::buffer_pool_cached_bytes() noexcept {
+    std::size_t ret  = 0;
+    auto        pool = this_thread_pool();
+    for (auto cls = 0u; pool && cls < n_size_classes; ++cls) {
+        ret += pool->counts[cls] * (min_pooled_buffer_size << cls);
+    }
+    return ret;
+}
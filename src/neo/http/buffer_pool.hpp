@@ -0,0 +1,73 @@
+#pragma once
+
+#include <neo/const_buffer.hpp>
+#include <neo/mutable_buffer.hpp>
+
+#include <cstddef>
+#include <utility>
+
+namespace neo::http {
+
+/// The smallest buffer handed out by acquire_buffer()
+constexpr std::size_t min_pooled_buffer_size = 256;
+/// The largest buffer that is returned to the pool. Larger buffers are freed when released.
+constexpr std::size_t max_pooled_buffer_size = 1024 * 1024;
+/// The number of free buffers that each thread keeps of each size
+constexpr std::size_t max_pooled_buffers_per_size = 4;
+
+/**
+ * A buffer borrowed from the calling thread's buffer pool with acquire_buffer(). It is returned
+ * to the pool of the thread that destroys it, ready to be handed out again without allocating.
+ */
+class pooled_buffer {
+    std::byte*  _data = nullptr;
+    std::size_t _size = 0;
+
+    pooled_buffer(std::byte* data, std::size_t size) noexcept
+        : _data(data)
+        , _size(size) {}
+
+    friend pooled_buffer acquire_buffer(std::size_t);
+
+public:
+    pooled_buffer() = default;
+    ~pooled_buffer() { reset(); }
+
+    pooled_buffer(pooled_buffer&& o) noexcept
+        : _data(std::exchange(o._data, nullptr))
+        , _size(std::exchange(o._size, 0)) {}
+
+    pooled_buffer& operator=(pooled_buffer&& o) noexcept {
+        if (this != &o) {
+            reset();
+            _data = std::exchange(o._data, nullptr);
+            _size = std::exchange(o._size, 0);
+        }
+        return *this;
+    }
+
+    std::byte*  data() const noexcept { return _data; }
+    std::size_t size() const noexcept { return _size; }
+
+    mutable_buffer buffer() const noexcept { return mutable_buffer(_data, _size); }
+
+    explicit operator bool() const noexcept { return _data != nullptr; }
+
+    /// Return the buffer to the pool, leaving this object empty
+    void reset() noexcept;
+};
+
+/**
+ * Borrow a buffer of at least `min_size` bytes. Sizes are rounded up to a power of two (at least
+ * min_pooled_buffer_size), and a buffer of that size is taken from the calling thread's free list
+ * if there is one. Only buffers up to max_pooled_buffer_size are pooled.
+ */
+pooled_buffer acquire_buffer(std::size_t min_size);
+
+/// Free the buffers that are waiting in the calling thread's pool
+void trim_buffer_pool() noexcept;
+
+/// The number of bytes in buffers waiting in the calling thread's pool
+std::size_t buffer_pool_cached_bytes() noexcept;
+
+}  // namespace neo::http
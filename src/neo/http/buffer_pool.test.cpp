@@ -0,0 +1,67 @@
+#include <neo/http/buffer_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("Buffers are rounded up to a power of two") {
+    neo::http::trim_buffer_pool();
+    CHECK(neo::http::acquire_buffer(1).size() == neo::http::min_pooled_buffer_size);
+    CHECK(neo::http::acquire_buffer(1000).size() == 1024);
+    CHECK(neo::http::acquire_buffer(1024).size() == 1024);
+    CHECK(neo::http::acquire_buffer(1025).size() == 2048);
+    // Larger buffers are not rounded, and are not pooled
+    auto big_size = neo::http::max_pooled_buffer_size + 1;
+    CHECK(neo::http::acquire_buffer(big_size).size() == big_size);
+    CHECK(neo::http::buffer_pool_cached_bytes() == 256 + 1024 + 2048);
+    neo::http::trim_buffer_pool();
+    CHECK(neo::http::buffer_pool_cached_bytes() == 0);
+}
+
+TEST_CASE("Released buffers are reused") {
+    neo::http::trim_buffer_pool();
+    auto buf  = neo::http::acquire_buffer(4000);
+    auto data = buf.data();
+    buf.reset();
+    CHECK_FALSE(buf);
+    CHECK(neo::http::buffer_pool_cached_bytes() == 4096);
+
+    // A buffer of a different size class doesn't take it
+    auto other = neo::http::acquire_buffer(8000);
+    CHECK(other.data() != data);
+
+    auto again = neo::http::acquire_buffer(3000);
+    CHECK(again.data() == data);
+    CHECK(again.size() == 4096);
+    CHECK(neo::http::buffer_pool_cached_bytes() == 0);
+
+    // Moving a buffer doesn't release it
+    auto moved = std::move(again);
+    CHECK_FALSE(again);
+    CHECK(moved.data() == data);
+    CHECK(neo::http::buffer_pool_cached_bytes() == 0);
+}
+
+TEST_CASE("The pool keeps a limited number of each size") {
+    neo::http::trim_buffer_pool();
+    {
+        std::vector<neo::http::pooled_buffer> bufs;
+        for (auto i = 0u; i < neo::http::max_pooled_buffers_per_size + 3; ++i) {
+            bufs.push_back(neo::http::acquire_buffer(512));
+        }
+    }
+    CHECK(neo::http::buffer_pool_cached_bytes()
+          == 512 * neo::http::max_pooled_buffers_per_size);
+    neo::http::trim_buffer_pool();
+}
+
+TEST_CASE("A buffer is returned to the pool of the thread that releases it") {
+    neo::http::trim_buffer_pool();
+    auto buf = neo::http::acquire_buffer(300);
+    std::thread([&] {
+        buf.reset();
+        CHECK(neo::http::buffer_pool_cached_bytes() == 512);
+    }).join();
+    CHECK(neo::http::buffer_pool_cached_bytes() == 0);
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "./gather.hpp"
+
+#include <neo/as_buffer.hpp>
+#include <neo/assert.hpp>
+#include <neo/buffer_algorithm/copy.hpp>
+#include <neo/buffer_algorithm/size.hpp>
+#include <neo/buffer_sink.hpp>
+#include <neo/const_buffer.hpp>
+#include <neo/mutable_buffer.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace neo::http {
+
+namespace detail {
+
+/// A chunk-size line: The chunk size in hex, followed by CRLF
+class chunk_size_line {
+    std::array<char, sizeof(std::size_t) * 2 + 2> _chars;
+    std::size_t                                   _size;
+
+public:
+    explicit chunk_size_line(std::size_t chunk_size) noexcept {
+        auto end = std::to_chars(_chars.data(), _chars.data() + _chars.size(), chunk_size, 16).ptr;
+        *end++   = '\r';
+        *end++   = '\n';
+        _size    = static_cast<std::size_t>(end - _chars.data());
+    }
+
+    const_buffer buffer() const noexcept { return as_buffer(_chars).first(_size); }
+};
+
+}  // namespace detail
+
+/**
+ * A buffer_sink that encodes the data written to it with the chunked transfer-coding, and writes
+ * the result to an inner sink.
+ *
+ * Data smaller than `min_chunk_size` is held back until enough has been written to fill a chunk,
+ * so that many small writes don't each become a tiny chunk. write() sends larger data in a single
+ * chunk, gathering the chunk head and the CRLF around the caller's buffer rather than copying it
+ * aside first.
+ *
+ * close() must be called to write any held-back data and the last chunk. The destructor does not
+ * do this.
+ */
+template <buffer_sink Inner>
+class chunked_writer {
+public:
+    static constexpr std::size_t default_min_chunk_size = 1024;
+
+private:
+    wrap_refs_t<Inner> _inner;
+
+    std::size_t _min_chunk_size = default_min_chunk_size;
+    // Data that is waiting to be written in a chunk. prepare() hands out the space past the end.
+    std::string _pending;
+    std::size_t _n_pending = 0;
+    bool        _closed    = false;
+
+    const_buffer _pending_buf() const noexcept { return as_buffer(_pending).first(_n_pending); }
+
+    template <typename Buffers>
+    void _write_all(const Buffers& bufs) {
+        if (buffer_copy(next_layer(), bufs) != buffer_size(bufs)) {
+            throw std::runtime_error("neo::http::chunked_writer's inner sink is full");
+        }
+    }
+
+    void _check_open() const noexcept {
+        neo_assert(expects, !_closed, "Cannot write to a chunked_writer after it is closed");
+    }
+
+public:
+    chunked_writer() = default;
+    explicit chunked_writer(Inner&& inner, std::size_t min_chunk_size = default_min_chunk_size)
+        : _inner(NEO_FWD(inner))
+        , _min_chunk_size(min_chunk_size) {}
+
+    NEO_DECL_UNREF_GETTER(next_layer, _inner);
+
+    constexpr bool closed() const noexcept { return _closed; }
+
+    /// The number of bytes that have been written but not yet sent in a chunk
+    constexpr std::size_t pending_size() const noexcept { return _n_pending; }
+
+    mutable_buffer prepare(std::size_t n) {
+        _check_open();
+        if (_pending.size() < _n_pending + n) {
+            _pending.resize(_n_pending + n);
+        }
+        return (as_buffer(_pending) + _n_pending).first(n);
+    }
+
+    void commit(std::size_t n) {
+        neo_assert(expects,
+                   _n_pending + n <= _pending.size(),
+                   "Cannot commit more bytes to a chunked_writer than were prepared",
+                   n,
+                   _pending.size() - _n_pending);
+        _n_pending += n;
+        if (_n_pending >= _min_chunk_size) {
+            flush();
+        }
+    }
+
+    /**
+     * Write `data`. If it (along with any held-back data) is at least `min_chunk_size` bytes, it is
+     * sent in one chunk right away without being copied into the writer.
+     */
+    std::size_t write(const_buffer data) {
+        _check_open();
+        if (data.empty()) {
+            return 0;
+        }
+        if (_n_pending + data.size() < _min_chunk_size) {
+            // Too small for a chunk of its own
+            buffer_copy(prepare(data.size()), data);
+            _n_pending += data.size();
+            return data.size();
+        }
+        detail::chunk_size_line head{_n_pending + data.size()};
+        _write_all(std::array<const_buffer, 4>{head.buffer(),
+                                               _pending_buf(),
+                                               data,
+                                               gather_detail::static_buf(gather_detail::crlf, 2)});
+        _n_pending = 0;
+        return data.size();
+    }
+
+    /// Send any held-back data in a chunk now
+    void flush() {
+        if (_n_pending == 0) {
+            // An empty chunk would be the last chunk
+            return;
+        }
+        detail::chunk_size_line head{_n_pending};
+        _write_all(std::array<const_buffer, 3>{head.buffer(),
+                                               _pending_buf(),
+                                               gather_detail::static_buf(gather_detail::crlf, 2)});
+        _n_pending = 0;
+    }
+
+    /**
+     * Send any held-back data, and then the last chunk followed by the given trailer fields. The
+     * trailers are a range of key-value pairs, like the headers of a message.
+     */
+    template <typename Trailers>
+    void close(const Trailers& trailers) {
+        _check_open();
+        flush();
+        gather_buffers bufs;
+        bufs.append(gather_detail::static_buf("0\r\n", 3));
+        gather_header_fields(bufs, trailers);
+        _write_all(bufs);
+        _closed = true;
+    }
+
+    /// Send any held-back data, and then the last chunk
+    void close() {
+        _check_open();
+        flush();
+        _write_all(gather_detail::static_buf("0\r\n\r\n", 5));
+        _closed = true;
+    }
+};
+
+template <buffer_sink S>
+explicit chunked_writer(S &&) -> chunked_writer<S>;
+
+template <buffer_sink S>
+chunked_writer(S &&, std::size_t) -> chunked_writer<S>;
+
+}  // namespace neo::http
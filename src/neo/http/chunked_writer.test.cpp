@@ -0,0 +1,87 @@
+#include <neo/http/chunked_writer.hpp>
+
+#include <neo/http/parse/chunked.hpp>
+
+#include <neo/string_io.hpp>
+#include <neo/test_concept.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+NEO_TEST_CONCEPT(neo::buffer_sink<neo::http::chunked_writer<neo::proto_buffer_sink>>);
+
+using namespace std::string_view_literals;
+
+TEST_CASE("Write a chunked body") {
+    neo::string_dynbuf_io      out;
+    neo::http::chunked_writer wr{out, 4};
+    wr.write(neo::const_buffer("Hello, "));
+    wr.write(neo::const_buffer("world!"));
+    wr.close();
+    CHECK(out.read_area_view()
+          == "7\r\n"
+             "Hello, \r\n"
+             "6\r\n"
+             "world!\r\n"
+             "0\r\n"
+             "\r\n");
+}
+
+TEST_CASE("Coalesce small writes") {
+    neo::string_dynbuf_io      out;
+    neo::http::chunked_writer wr{out, 10};
+    for (auto word : {"Some"sv, " "sv, "small"sv, " "sv, "writes"sv}) {
+        // Through the buffer_sink interface, as buffer_copy() would
+        neo::buffer_copy(wr, neo::const_buffer(word));
+    }
+    CHECK(out.read_area_view() == "a\r\nSome small\r\n");
+    CHECK(wr.pending_size() == 7);
+    wr.write(neo::const_buffer("!"));
+    CHECK(wr.pending_size() == 8);
+    wr.close();
+    CHECK(out.read_area_view()
+          == "a\r\n"
+             "Some small\r\n"
+             "8\r\n"
+             " writes!\r\n"
+             "0\r\n"
+             "\r\n");
+}
+
+TEST_CASE("Write a large chunk along with held-back data") {
+    neo::string_dynbuf_io      out;
+    neo::http::chunked_writer wr{out};
+    wr.write(neo::const_buffer("Header"));
+    std::string big(5000, 'x');
+    wr.write(neo::const_buffer(big));
+    CHECK(wr.pending_size() == 0);
+    wr.close();
+
+    std::string encoded(out.read_area_view());
+    CHECK(encoded.substr(0, 6) == "138e\r\n");
+    auto res = neo::http::dechunk_in_place(neo::mutable_buffer(encoded));
+    CHECK(res.status == neo::http::dechunked_buffer::status_t::done);
+    CHECK(std::string_view(res.body) == "Header" + big);
+}
+
+TEST_CASE("Write trailer fields") {
+    neo::string_dynbuf_io      out;
+    neo::http::chunked_writer wr{out};
+    wr.write(neo::const_buffer("data"));
+    std::vector<std::pair<std::string, std::string>> trailers = {
+        {"Checksum", "1234"},
+        {"Expires", "never"},
+    };
+    wr.close(trailers);
+    CHECK(wr.closed());
+    CHECK(out.read_area_view()
+          == "4\r\n"
+             "data\r\n"
+             "0\r\n"
+             "Checksum: 1234\r\n"
+             "Expires: never\r\n"
+             "\r\n");
+}
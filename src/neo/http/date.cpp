@@ -0,0 +1,278 @@
+#include "./date.hpp"
+
+#include <cstdint>
+#include <ctime>
+#include <tuple>
+
+using namespace std::string_view_literals;
+
+namespace {
+
+// Refer: http://howardhinnant.github.io/date_algorithms.html
+constexpr std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d) noexcept {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto         yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned     doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned     doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+struct civil_date {
+    std::int64_t year;
+    unsigned     month;
+    unsigned     day;
+};
+
+constexpr civil_date civil_from_days(std::int64_t z) noexcept {
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto         doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned     yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned     doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned     mp  = (5 * doy + 2) / 153;
+    const unsigned     d   = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned     m   = mp < 10 ? mp + 3 : mp - 9;
+    return {static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+static_assert(days_from_civil(1970, 1, 1) == 0);
+static_assert(civil_from_days(0).year == 1970);
+
+constexpr std::string_view short_day_names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+constexpr std::string_view long_day_names[]
+    = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+constexpr std::string_view month_names[]
+    = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+constexpr unsigned days_in_month[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/// 1970-01-01 was a Thursday
+constexpr unsigned weekday_of(std::int64_t days) noexcept {
+    return static_cast<unsigned>(((days + 4) % 7 + 7) % 7);
+}
+
+void put_2(char* out, unsigned n) noexcept {
+    out[0] = static_cast<char>('0' + n / 10);
+    out[1] = static_cast<char>('0' + n % 10);
+}
+
+std::int64_t coarse_now_seconds() noexcept {
+#if defined(CLOCK_REALTIME_COARSE)
+    // Reading the coarse clock doesn't need to touch the hardware, and we only want seconds
+    ::timespec ts;
+    if (::clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+        return static_cast<std::int64_t>(ts.tv_sec);
+    }
+#endif
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+/// Parse two ASCII digits, or return a value greater than 99 if they are not digits
+unsigned parse_2(const char* p) noexcept {
+    auto hi = static_cast<unsigned>(p[0] - '0');
+    auto lo = static_cast<unsigned>(p[1] - '0');
+    return (hi > 9 || lo > 9) ? 1000 : hi * 10 + lo;
+}
+
+/// Find `name` in `names`, or return `N` if it isn't there
+template <std::size_t N>
+unsigned find_name(const std::string_view (&names)[N], std::string_view name) noexcept {
+    unsigned idx = 0;
+    while (idx < N && names[idx] != name) {
+        ++idx;
+    }
+    return idx;
+}
+
+struct time_of_day {
+    unsigned hour   = 100;
+    unsigned minute = 100;
+    unsigned second = 100;
+
+    bool valid() const noexcept { return hour < 24 && minute < 60 && second <= 60; }
+};
+
+/// Parse "HH:MM:SS"
+time_of_day parse_time(std::string_view str) noexcept {
+    if (str[2] != ':' || str[5] != ':') {
+        return {};
+    }
+    return {parse_2(str.data()), parse_2(str.data() + 3), parse_2(str.data() + 6)};
+}
+
+std::optional<neo::http::http_date>
+make_date(std::int64_t year, unsigned month_idx, unsigned day, time_of_day time) noexcept {
+    if (month_idx >= 12 || day == 0 || day > days_in_month[month_idx] || !time.valid()) {
+        return std::nullopt;
+    }
+    auto month = month_idx + 1;
+    bool leap  = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    if (month == 2 && day == 29 && !leap) {
+        return std::nullopt;
+    }
+    auto secs = days_from_civil(year, month, day) * 86400 + time.hour * 3600 + time.minute * 60
+        + time.second;
+    return neo::http::http_date(std::chrono::seconds(secs));
+}
+
+// "Sun, 06 Nov 1994 08:49:37 GMT"
+std::optional<neo::http::http_date> parse_imf_fixdate(std::string_view str) noexcept {
+    if (str.size() != neo::http::imf_fixdate_size || str.substr(3, 2) != ", " || str[7] != ' '
+        || str[11] != ' ' || str[16] != ' ' || str.substr(25) != " GMT"sv
+        || find_name(short_day_names, str.substr(0, 3)) == 7) {
+        return std::nullopt;
+    }
+    auto day   = parse_2(str.data() + 5);
+    auto month = find_name(month_names, str.substr(8, 3));
+    auto y_hi  = parse_2(str.data() + 12);
+    auto y_lo  = parse_2(str.data() + 14);
+    if (y_hi > 99 || y_lo > 99) {
+        return std::nullopt;
+    }
+    return make_date(y_hi * 100 + y_lo, month, day, parse_time(str.substr(17, 8)));
+}
+
+/**
+ * The year of a two-digit RFC 850 year, as seen at `now` (in seconds since the epoch). A date that
+ * would be more than 50 years in the future is in the most recent past year with the same last
+ * two digits (RFC 7231 section 7.1.1.1).
+ */
+std::int64_t
+rfc850_year(unsigned yy, unsigned month_idx, unsigned day, time_of_day time, std::int64_t now) {
+    auto now_days = now >= 0 ? now / 86400 : (now - 86399) / 86400;
+    auto now_secs = now - now_days * 86400;
+    auto today    = civil_from_days(now_days);
+
+    auto more_than_50_years_ahead = [&](std::int64_t year) {
+        auto limit_year = today.year + 50;
+        if (year != limit_year) {
+            return year > limit_year;
+        }
+        auto secs = static_cast<std::int64_t>(time.hour * 3600 + time.minute * 60 + time.second);
+        return std::tuple(month_idx + 1, day, secs) > std::tuple(today.month, today.day, now_secs);
+    };
+    // Start a century ahead, which may still be within the window, and step back
+    auto year = today.year - (today.year % 100 + 100) % 100 + yy + 100;
+    while (more_than_50_years_ahead(year)) {
+        year -= 100;
+    }
+    return year;
+}
+
+// "Sunday, 06-Nov-94 08:49:37 GMT"
+std::optional<neo::http::http_date> parse_rfc850_date(std::string_view str,
+                                                      std::int64_t     now) noexcept {
+    auto comma = str.find(',');
+    if (comma == str.npos || find_name(long_day_names, str.substr(0, comma)) == 7) {
+        return std::nullopt;
+    }
+    str = str.substr(comma + 1);
+    if (str.size() != 23 || str[0] != ' ' || str[3] != '-' || str[7] != '-' || str[10] != ' '
+        || str.substr(19) != " GMT"sv) {
+        return std::nullopt;
+    }
+    auto day   = parse_2(str.data() + 1);
+    auto month = find_name(month_names, str.substr(4, 3));
+    auto yy    = parse_2(str.data() + 8);
+    if (yy > 99) {
+        return std::nullopt;
+    }
+    auto time = parse_time(str.substr(11, 8));
+    return make_date(rfc850_year(yy, month, day, time, now), month, day, time);
+}
+
+// "Sun Nov  6 08:49:37 1994"
+std::optional<neo::http::http_date> parse_asctime_date(std::string_view str) noexcept {
+    if (str.size() != 24 || str[3] != ' ' || str[7] != ' ' || str[10] != ' ' || str[19] != ' '
+        || find_name(short_day_names, str.substr(0, 3)) == 7) {
+        return std::nullopt;
+    }
+    auto month = find_name(month_names, str.substr(4, 3));
+    // A single-digit day is padded with a space
+    auto day = parse_2(str.data() + 8);
+    if (str[8] == ' ') {
+        auto digit = static_cast<unsigned>(str[9] - '0');
+        day        = digit > 9 ? 1000 : digit;
+    }
+    auto y_hi = parse_2(str.data() + 20);
+    auto y_lo = parse_2(str.data() + 22);
+    if (y_hi > 99 || y_lo > 99) {
+        return std::nullopt;
+    }
+    return make_date(y_hi * 100 + y_lo, month, day, parse_time(str.substr(11, 8)));
+}
+
+}  // namespace
+
+std::array<char, neo::http::imf_fixdate_size>
+neo::http::format_imf_fixdate(http_date date) noexcept {
+    auto secs     = date.time_since_epoch().count();
+    auto days     = secs >= 0 ? secs / 86400 : (secs - 86399) / 86400;
+    auto day_secs = static_cast<unsigned>(secs - days * 86400);
+    auto civil    = civil_from_days(days);
+    // IMF-fixdate only has room for four digits of year
+    auto year = static_cast<unsigned>(civil.year < 0 ? 0 : civil.year > 9999 ? 9999 : civil.year);
+
+    std::array<char, imf_fixdate_size> ret;
+    char*                              out = ret.data();
+    auto                               put = [&](std::string_view str) {
+        for (char c : str) {
+            *out++ = c;
+        }
+    };
+    put(short_day_names[weekday_of(days)]);
+    put(", ");
+    put_2(out, civil.day);
+    out += 2;
+    put(" ");
+    put(month_names[civil.month - 1]);
+    put(" ");
+    put_2(out, year / 100);
+    put_2(out + 2, year % 100);
+    out += 4;
+    put(" ");
+    put_2(out, day_secs / 3600);
+    put_2(out + 3, day_secs / 60 % 60);
+    put_2(out + 6, day_secs % 60);
+    out[2] = out[5] = ':';
+    out += 8;
+    put(" GMT");
+    return ret;
+}
+
+std::string_view neo::http::current_http_date() noexcept {
+    struct cache {
+        std::int64_t                       second = -1;
+        std::array<char, imf_fixdate_size> text   = {};
+    };
+    thread_local cache tl_cache;
+
+    auto now = coarse_now_seconds();
+    if (now != tl_cache.second) {
+        tl_cache.text   = format_imf_fixdate(http_date(std::chrono::seconds(now)));
+        tl_cache.second = now;
+    }
+    return std::string_view(tl_cache.text.data(), tl_cache.text.size());
+}
+
+std::optional<neo::http::http_date> neo::http::parse_http_date(std::string_view str) noexcept {
+    return parse_http_date(str, http_date(std::chrono::seconds(coarse_now_seconds())));
+}
+
+std::optional<neo::http::http_date> neo::http::parse_http_date(std::string_view str,
+                                                               http_date        now) noexcept {
+    // The fourth character tells the formats apart
+    if (str.size() < 4) {
+        return std::nullopt;
+    }
+    switch (str[3]) {
+    case ',':
+        return parse_imf_fixdate(str);
+    case ' ':
+        return parse_asctime_date(str);
+    default:
+        return parse_rfc850_date(str, now.time_since_epoch().count());
+    }
+}
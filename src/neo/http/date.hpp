@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace neo::http {
+
+/// An HTTP-date. HTTP dates have a resolution of one second.
+using http_date = std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+
+/// The length of an IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+constexpr std::size_t imf_fixdate_size = 29;
+
+/// Render `date` as an IMF-fixdate (RFC 7231 section 7.1.1.1)
+std::array<char, imf_fixdate_size> format_imf_fixdate(http_date date) noexcept;
+
+/**
+ * The current time as an IMF-fixdate, suitable for a `Date` header.
+ *
+ * The text is cached per-thread and only re-rendered when the second changes, and the time is
+ * read from a coarse (cheap, low-resolution) clock where one is available. The returned view
+ * refers to thread-local storage, and is valid until the next call on the same thread.
+ */
+std::string_view current_http_date() noexcept;
+
+/**
+ * Parse an HTTP-date in any of the three formats that RFC 7231 requires recipients to accept:
+ * IMF-fixdate, the obsolete RFC 850 format, and ANSI C's asctime() format. A two-digit RFC 850
+ * year is taken to be within 50 years of the current time: a date that would be more than 50
+ * years in the future is in the most recent past year with the same last two digits (RFC 7231
+ * section 7.1.1.1).
+ *
+ * Returns nullopt if `str` is not a valid HTTP-date.
+ */
+std::optional<http_date> parse_http_date(std::string_view str) noexcept;
+
+/// Parse an HTTP-date, reading two-digit RFC 850 years as of the time `now`
+std::optional<http_date> parse_http_date(std::string_view str, http_date now) noexcept;
+
+}  // namespace neo::http
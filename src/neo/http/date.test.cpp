@@ -0,0 +1,98 @@
+#include <neo/http/date.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <string>
+
+using neo::http::http_date;
+
+namespace {
+std::string format(http_date date) {
+    auto arr = neo::http::format_imf_fixdate(date);
+    return std::string(arr.data(), arr.size());
+}
+}  // namespace
+
+TEST_CASE("Format IMF-fixdates") {
+    CHECK(format(http_date(std::chrono::seconds(0))) == "Thu, 01 Jan 1970 00:00:00 GMT");
+    CHECK(format(http_date(std::chrono::seconds(784111777))) == "Sun, 06 Nov 1994 08:49:37 GMT");
+    CHECK(format(http_date(std::chrono::seconds(951782400))) == "Tue, 29 Feb 2000 00:00:00 GMT");
+    CHECK(format(http_date(std::chrono::seconds(-1))) == "Wed, 31 Dec 1969 23:59:59 GMT");
+}
+
+TEST_CASE("Parse HTTP-dates") {
+    auto expect = http_date(std::chrono::seconds(784111777));
+    CHECK(neo::http::parse_http_date("Sun, 06 Nov 1994 08:49:37 GMT") == expect);
+    CHECK(neo::http::parse_http_date("Sunday, 06-Nov-94 08:49:37 GMT") == expect);
+    CHECK(neo::http::parse_http_date("Sun Nov  6 08:49:37 1994") == expect);
+    CHECK(neo::http::parse_http_date("Sun Nov 16 08:49:37 1994")
+          == expect + std::chrono::hours(24 * 10));
+    CHECK(neo::http::parse_http_date("Monday, 01-Jan-24 00:00:00 GMT")
+          == http_date(std::chrono::seconds(1704067200)));
+
+    std::string_view bad_dates[] = {
+        "",
+        "Sun",
+        "Sun, 06 Nov 1994 08:49:37 UTC",
+        "Sun, 06 Nov 1994 08:49:37 GMT ",
+        "sun, 06 Nov 1994 08:49:37 GMT",
+        "Sun, 06 Nvv 1994 08:49:37 GMT",
+        "Sun, 32 Jan 1994 08:49:37 GMT",
+        "Sun, 29 Feb 1900 08:49:37 GMT",
+        "Sun, 06 Nov 1994 24:49:37 GMT",
+        "Sun, 06 Nov 1994 08:60:37 GMT",
+        "Sun, 06 Nov 1994 08-49-37 GMT",
+        "Sun, 06 Nov 19x4 08:49:37 GMT",
+        "Sun, 6 Nov 1994 08:49:37 GMT",
+        "Sunday, 06-Nov-1994 08:49:37 GMT",
+        "Sundae, 06-Nov-94 08:49:37 GMT",
+        "Sun Nov  : 08:49:37 1994",
+        "Sun Nov 6 08:49:37 1994",
+    };
+    for (auto str : bad_dates) {
+        CAPTURE(str);
+        CHECK_FALSE(neo::http::parse_http_date(str));
+    }
+}
+
+TEST_CASE("Two-digit years are within 50 years of now") {
+    auto parse = [](std::string_view str, std::int64_t now) {
+        return neo::http::parse_http_date(str, http_date(std::chrono::seconds(now)));
+    };
+    auto secs = [](std::int64_t n) { return http_date(std::chrono::seconds(n)); };
+
+    // 2026-10-17
+    std::int64_t now = 1792195200;
+    CHECK(parse("Sunday, 06-Nov-94 08:49:37 GMT", now) == secs(784111777));
+    CHECK(parse("Wednesday, 01-Jan-76 00:00:00 GMT", now) == secs(3345062400));
+    // More than 50 years ahead, by a few days or by a year
+    CHECK(parse("Sunday, 31-Oct-76 00:00:00 GMT", now) == secs(215568000));
+    CHECK(parse("Saturday, 01-Jan-77 00:00:00 GMT", now) == secs(220924800));
+    CHECK(parse("Thursday, 01-Jan-70 00:00:00 GMT", now) == secs(3155760000));
+    CHECK(parse("Tuesday, 29-Feb-00 00:00:00 GMT", now) == secs(951782400));
+    // As of 2000-01-01, 2070 is too far ahead
+    CHECK(parse("Thursday, 01-Jan-70 00:00:00 GMT", 946684800) == secs(0));
+
+    // Near the end of a century, the window reaches into the next one. 2095-01-01:
+    CHECK(parse("Sunday, 01-Jun-10 00:00:00 GMT", 3944678400) == secs(4431024000));
+}
+
+TEST_CASE("Format and parse round-trip") {
+    for (std::int64_t secs = -86400 * 365; secs < 4'000'000'000; secs += 7'654'321) {
+        auto date = http_date(std::chrono::seconds(secs));
+        CAPTURE(secs);
+        CHECK(neo::http::parse_http_date(format(date)) == date);
+    }
+}
+
+TEST_CASE("Get the current date") {
+    auto now  = std::chrono::system_clock::now();
+    auto text = neo::http::current_http_date();
+    CHECK(text.size() == neo::http::imf_fixdate_size);
+    auto parsed = neo::http::parse_http_date(text);
+    REQUIRE(parsed);
+    CHECK(std::chrono::abs(*parsed - now) < std::chrono::seconds(5));
+    // The cached text is stable
+    CHECK(neo::http::current_http_date().data() == text.data());
+}
@@ -0,0 +1,236 @@
+#include "./fd_io.hpp"
+
+#if !defined(_WIN32)
+
+#include "./trace.hpp"
+
+#include <neo/buffer_algorithm/copy.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+using namespace neo;
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::system_category(), what);
+}
+
+void write_all(int fd, const_buffer buf) {
+    while (!buf.empty()) {
+        auto n = ::write(fd, buf.data(), buf.size());
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("neo::http write() to a file descriptor failed");
+        }
+        buf += static_cast<std::size_t>(n);
+    }
+}
+
+// The most we ask the kernel to move in a single call
+constexpr std::uint64_t max_transfer_step = 1 << 30;
+
+std::size_t step_size(std::uint64_t remaining) noexcept {
+    return static_cast<std::size_t>((std::min)(remaining, max_transfer_step));
+}
+
+std::uint64_t copy_fd(int in_fd, int out_fd, std::uint64_t max) {
+    auto          buf   = http::acquire_buffer(64 * 1024);
+    std::uint64_t total = 0;
+    while (total < max) {
+        auto n = ::read(in_fd, buf.data(), (std::min)(buf.size(), step_size(max - total)));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("neo::http read() from a file descriptor failed");
+        }
+        if (n == 0) {
+            break;
+        }
+        write_all(out_fd, const_buffer(buf.data(), static_cast<std::size_t>(n)));
+        total += static_cast<std::uint64_t>(n);
+    }
+    return total;
+}
+
+#if defined(__linux__)
+
+bool is_pipe(int fd) noexcept {
+    struct ::stat st;
+    return ::fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+bool is_regular_file(int fd) noexcept {
+    struct ::stat st;
+    return ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+/// Call splice(), retrying on EINTR. Returns -1 with errno set on failure.
+::ssize_t splice_some(int in_fd, int out_fd, std::size_t n) noexcept {
+    while (true) {
+        auto ret = ::splice(in_fd, nullptr, out_fd, nullptr, n, SPLICE_F_MOVE);
+        if (ret >= 0 || errno != EINTR) {
+            return ret;
+        }
+    }
+}
+
+/// A pipe to splice() through, closed on destruction
+struct splice_pipe {
+    int fds[2] = {-1, -1};
+
+    splice_pipe() {
+        if (::pipe2(fds, O_CLOEXEC) != 0) {
+            throw_errno("neo::http failed to create a pipe for splice()");
+        }
+    }
+    ~splice_pipe() {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+    splice_pipe(const splice_pipe&) = delete;
+    splice_pipe& operator=(const splice_pipe&) = delete;
+};
+
+/// Move everything in `pipe_fd` to `out_fd`
+void drain_pipe(int pipe_fd, int out_fd, std::size_t n) {
+    while (n != 0) {
+        auto moved = splice_some(pipe_fd, out_fd, n);
+        if (moved <= 0) {
+            throw_errno("neo::http splice() from a pipe failed");
+        }
+        n -= static_cast<std::size_t>(moved);
+    }
+}
+
+#endif
+
+}  // namespace
+
+const_buffer http::fd_source::next(std::size_t n) {
+    // Asking for nothing must not wait for more input that may never come
+    if (_begin == _end && n != 0) {
+        _begin = _end = 0;
+        while (true) {
+            auto got = ::read(_fd, _buf.data(), _buf.size());
+            if (got >= 0) {
+                _end = static_cast<std::size_t>(got);
+                break;
+            }
+            if (errno != EINTR) {
+                throw_errno("neo::http read() from a file descriptor failed");
+            }
+        }
+    }
+    return buffered().first((std::min)(n, _end - _begin));
+}
+
+void http::fd_sink::commit(std::size_t n) { write_all(_fd, const_buffer(_buf.data(), n)); }
+
+std::uint64_t http::transfer_fd(int in_fd, int out_fd, std::uint64_t max) {
+#if defined(__linux__)
+    std::uint64_t total = 0;
+    if (is_regular_file(in_fd)) {
+        while (total < max) {
+            auto n = ::sendfile(out_fd, in_fd, nullptr, step_size(max - total));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && total == 0 && (errno == EINVAL || errno == ENOSYS)) {
+                // This pair of descriptors doesn't support sendfile()
+                return copy_fd(in_fd, out_fd, max);
+            }
+            if (n < 0) {
+                throw_errno("neo::http sendfile() failed");
+            }
+            if (n == 0) {
+                break;
+            }
+            total += static_cast<std::uint64_t>(n);
+        }
+        return total;
+    }
+
+    if (is_pipe(in_fd) || is_pipe(out_fd)) {
+        while (total < max) {
+            auto n = splice_some(in_fd, out_fd, step_size(max - total));
+            if (n < 0 && total == 0 && errno == EINVAL) {
+                return copy_fd(in_fd, out_fd, max);
+            }
+            if (n < 0) {
+                throw_errno("neo::http splice() failed");
+            }
+            if (n == 0) {
+                break;
+            }
+            total += static_cast<std::uint64_t>(n);
+        }
+        return total;
+    }
+
+    // Neither end is a pipe, so splice through one of our own
+    splice_pipe pipe;
+    while (total < max) {
+        auto n = splice_some(in_fd, pipe.fds[1], step_size(max - total));
+        if (n < 0 && total == 0 && errno == EINVAL) {
+            return copy_fd(in_fd, out_fd, max);
+        }
+        if (n < 0) {
+            throw_errno("neo::http splice() failed");
+        }
+        if (n == 0) {
+            break;
+        }
+        drain_pipe(pipe.fds[0], out_fd, static_cast<std::size_t>(n));
+        total += static_cast<std::uint64_t>(n);
+    }
+    return total;
+#else
+    return copy_fd(in_fd, out_fd, max);
+#endif
+}
+
+std::uint64_t http::forward_body(fd_sink& out, body_source<fd_source>& body) {
+    using kind_t = body_source<fd_source>::kind_t;
+    if (body.kind() != kind_t::length && body.kind() != kind_t::until_close) {
+        auto n_copied = buffer_copy(out, body);
+        NEO_HTTP_PROBE1(body_done, n_copied);
+        return n_copied;
+    }
+
+    auto&         in    = body.next_layer();
+    std::uint64_t total = 0;
+    // First send what the source has already read into its buffer
+    while (!body.done() && !in.buffered().empty()) {
+        const_buffer part = body.next(in.buffered().size());
+        write_all(out.fd(), part);
+        body.consume(part.size());
+        total += part.size();
+    }
+
+    auto limit = body.remaining().value_or((std::numeric_limits<std::uint64_t>::max)());
+    auto moved = transfer_fd(in.fd(), out.fd(), limit);
+    body.mark_transferred(moved);
+    total += moved;
+    if (body.kind() == kind_t::length && !body.done()) {
+        throw std::runtime_error("HTTP message body ended before its Content-Length");
+    }
+    NEO_HTTP_PROBE1(body_done, total);
+    return total;
+}
+
+#endif
@@ -0,0 +1,105 @@
+#pragma once
+
+#if !defined(_WIN32)
+
+#include "./body_source.hpp"
+#include "./buffer_pool.hpp"
+
+#include <neo/const_buffer.hpp>
+#include <neo/mutable_buffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace neo::http {
+
+/**
+ * A buffer_source that reads from a file descriptor (a socket, pipe, or file) through a buffer.
+ * The descriptor is not owned, and must be in blocking mode. The buffer is borrowed from the
+ * thread's buffer pool, so creating an fd_source for each new connection doesn't allocate.
+ */
+class fd_source {
+    int           _fd;
+    pooled_buffer _buf;
+    std::size_t   _begin = 0;
+    std::size_t   _end   = 0;
+
+public:
+    static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+    explicit fd_source(int fd, std::size_t buffer_size = default_buffer_size)
+        : _fd(fd)
+        , _buf(acquire_buffer(buffer_size)) {}
+
+    int fd() const noexcept { return _fd; }
+
+    /// The bytes that have been read from the descriptor but not consumed
+    const_buffer buffered() const noexcept {
+        return const_buffer(_buf.data() + _begin, _end - _begin);
+    }
+
+    /**
+     * Get up to `n` buffered bytes, reading from the descriptor first if there are none. If `n` is
+     * zero this never reads.
+     */
+    const_buffer next(std::size_t n);
+
+    void consume(std::size_t n) noexcept {
+        neo_assert(expects,
+                   n <= _end - _begin,
+                   "Cannot consume more bytes than were returned by fd_source::next()",
+                   n,
+                   _end - _begin);
+        _begin += n;
+    }
+};
+
+/**
+ * A buffer_sink that writes to a file descriptor. Committed bytes are written before commit()
+ * returns. The descriptor is not owned, and must be in blocking mode.
+ */
+class fd_sink {
+    int           _fd;
+    pooled_buffer _buf;
+
+public:
+    explicit fd_sink(int fd)
+        : _fd(fd) {}
+
+    int fd() const noexcept { return _fd; }
+
+    mutable_buffer prepare(std::size_t n) {
+        if (_buf.size() < n) {
+            _buf = acquire_buffer(n);
+        }
+        return mutable_buffer(_buf.data(), n);
+    }
+
+    void commit(std::size_t n);
+};
+
+/**
+ * Move up to `max` bytes from the descriptor `in_fd` to `out_fd` inside the kernel, without
+ * passing through user space where possible. On Linux this uses sendfile() when the input is a
+ * file, and splice() (through a pipe, if neither end is one) otherwise, and falls back to read()
+ * and write() when neither applies.
+ *
+ * Stops early at the end of the input. Returns the number of bytes moved, and throws
+ * std::system_error on failure.
+ */
+std::uint64_t transfer_fd(int in_fd, int out_fd, std::uint64_t max);
+
+/**
+ * Forward a message body from its input to `out`. If the body has a Content-Length or runs until
+ * close, then the bytes already buffered by the source are written first, and the rest is moved
+ * with transfer_fd(). Chunked bodies are copied through user space.
+ *
+ * Returns the number of bytes of the body that were forwarded. Throws if a body with a
+ * Content-Length ends early.
+ */
+std::uint64_t forward_body(fd_sink& out, body_source<fd_source>& body);
+
+}  // namespace neo::http
+
+#endif
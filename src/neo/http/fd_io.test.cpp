@@ -0,0 +1,158 @@
+#include <neo/http/fd_io.hpp>
+
+#if !defined(_WIN32)
+
+#include <neo/http/response.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+/// A temporary file that is deleted when closed
+struct temp_file {
+    std::FILE* file = std::tmpfile();
+
+    temp_file() { REQUIRE(file); }
+    ~temp_file() { std::fclose(file); }
+
+    int fd() const noexcept { return ::fileno(file); }
+
+    void write(std::string_view str) {
+        REQUIRE(::write(fd(), str.data(), str.size()) == static_cast<::ssize_t>(str.size()));
+        ::lseek(fd(), 0, SEEK_SET);
+    }
+
+    std::string read_all() {
+        ::lseek(fd(), 0, SEEK_SET);
+        std::string ret;
+        char        buf[4096];
+        while (auto n = ::read(fd(), buf, sizeof buf)) {
+            REQUIRE(n > 0);
+            ret.append(buf, static_cast<std::size_t>(n));
+        }
+        return ret;
+    }
+};
+
+const std::string big_body = [] {
+    std::string ret;
+    for (int n = 0; ret.size() < 300'000; ++n) {
+        ret += std::to_string(n) + ",";
+    }
+    return ret;
+}();
+
+std::string response_text(std::string_view body) {
+    return "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n"
+        + std::string(body) + "HTTP/1.1 204 No Content\r\n\r\n";
+}
+
+}  // namespace
+
+TEST_CASE("Forward a body from a file to a file") {
+    temp_file in_file;
+    in_file.write(response_text(big_body));
+    temp_file out_file;
+
+    // A small buffer, so most of the body stays in the kernel
+    neo::http::fd_source in{in_file.fd(), 256};
+    neo::http::fd_sink   out{out_file.fd()};
+    auto                 res = neo::http::read_response_head_and_body(in);
+    CHECK(res.head.status == 200);
+    CHECK(neo::http::forward_body(out, res.body) == big_body.size());
+    CHECK(res.body.done());
+    CHECK(out_file.read_all() == big_body);
+
+    // The next response is still there
+    auto next = neo::http::read_response_head<neo::http::simple_response>(in);
+    CHECK(next.status == 204);
+}
+
+TEST_CASE("Forward a body from a socket to a file") {
+    int socks[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, socks) == 0);
+
+    auto        text = response_text(big_body);
+    std::thread writer{[&] {
+        neo::http::fd_sink sink{socks[1]};
+        neo::buffer_copy(sink, neo::const_buffer(text));
+        ::shutdown(socks[1], SHUT_WR);
+    }};
+
+    temp_file            out_file;
+    neo::http::fd_source in{socks[0], 1024};
+    neo::http::fd_sink   out{out_file.fd()};
+    auto                 res = neo::http::read_response_head_and_body(in);
+    CHECK(neo::http::forward_body(out, res.body) == big_body.size());
+    writer.join();
+    CHECK(out_file.read_all() == big_body);
+    ::close(socks[0]);
+    ::close(socks[1]);
+}
+
+TEST_CASE("Forward a chunked body by copying") {
+    temp_file in_file;
+    in_file.write(
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nHello\r\n"
+        "0\r\n\r\n");
+    temp_file out_file;
+
+    neo::http::fd_source in{in_file.fd()};
+    neo::http::fd_sink   out{out_file.fd()};
+    auto                 res = neo::http::read_response_head_and_body(in);
+    CHECK(neo::http::forward_body(out, res.body) == 5);
+    CHECK(out_file.read_all() == "Hello");
+}
+
+TEST_CASE("Forward a chunked body from a socket that stays open") {
+    int socks[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, socks) == 0);
+    // If we wrongly wait for more input, fail rather than hang
+    ::timeval timeout = {5, 0};
+    REQUIRE(::setsockopt(socks[0], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout) == 0);
+
+    // The peer sends one response and keeps the connection open for the next
+    std::string_view text
+        = "HTTP/1.1 200 OK\r\n"
+          "Transfer-Encoding: chunked\r\n"
+          "\r\n"
+          "5\r\nHello\r\n"
+          "6\r\n world\r\n"
+          "0\r\n\r\n";
+    REQUIRE(::write(socks[1], text.data(), text.size()) == static_cast<::ssize_t>(text.size()));
+
+    temp_file            out_file;
+    neo::http::fd_source in{socks[0]};
+    neo::http::fd_sink   out{out_file.fd()};
+    auto                 res = neo::http::read_response_head_and_body(in);
+    CHECK(neo::http::forward_body(out, res.body) == 11);
+    CHECK(res.body.done());
+    CHECK(out_file.read_all() == "Hello world");
+    CHECK(in.next(0).size() == 0);
+    ::close(socks[0]);
+    ::close(socks[1]);
+}
+
+TEST_CASE("Body ends before its Content-Length") {
+    temp_file in_file;
+    in_file.write("HTTP/1.1 200 OK\r\nContent-Length: 1000000\r\n\r\nToo short");
+    temp_file out_file;
+
+    neo::http::fd_source in{in_file.fd(), 16};
+    neo::http::fd_sink   out{out_file.fd()};
+    auto                 res = neo::http::read_response_head_and_body(in);
+    CHECK_THROWS(neo::http::forward_body(out, res.body));
+}
+
+#endif
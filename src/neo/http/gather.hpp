@@ -0,0 +1,182 @@
+#pragma once
+
+#include "./parse/request.hpp"
+#include "./parse/status.hpp"
+#include "./parse/version.hpp"
+
+#include <neo/as_buffer.hpp>
+#include <neo/assert.hpp>
+#include <neo/buffer_algorithm/copy.hpp>
+#include <neo/const_buffer.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace neo::http {
+
+namespace gather_detail {
+
+/// The three ASCII digits of every status code from 100 to 999, back-to-back
+inline constexpr std::array<char, 900 * 3> status_digits = [] {
+    std::array<char, 900 * 3> ret = {};
+    for (int code = 100; code < 1000; ++code) {
+        auto pos     = static_cast<std::size_t>(code - 100) * 3;
+        ret[pos]     = static_cast<char>('0' + code / 100);
+        ret[pos + 1] = static_cast<char>('0' + code / 10 % 10);
+        ret[pos + 2] = static_cast<char>('0' + code % 10);
+    }
+    return ret;
+}();
+
+inline constexpr char crlf[]      = "\r\n";
+inline constexpr char space[]     = " ";
+inline constexpr char colon_sp[]  = ": ";
+inline constexpr char query_sep[] = "?";
+
+inline const_buffer static_buf(const char* str, std::size_t size) noexcept {
+    return const_buffer(reinterpret_cast<const std::byte*>(str), size);
+}
+
+}  // namespace gather_detail
+
+/**
+ * A sequence of buffers that refers to the pieces of a message rather than copying them.
+ *
+ * The buffers point into the caller's strings, or into static storage for separators and status
+ * codes, so they are only valid while the caller's strings are. A gather_buffers is a buffer
+ * sequence for use with buffer_copy(), and fill_iovecs() produces an array for writev() or
+ * sendmsg(). Calling clear() and then reusing the object keeps its capacity.
+ *
+ * The first `inline_capacity` buffers are stored in the object itself, which is enough for a head
+ * with about a dozen header fields, so gathering a typical message does not allocate.
+ */
+class gather_buffers {
+public:
+    static constexpr std::size_t inline_capacity = 56;
+
+private:
+    std::array<const_buffer, inline_capacity> _inline;
+    // Holds every buffer once there are more than inline_capacity
+    std::vector<const_buffer> _spilled;
+    std::size_t               _count = 0;
+    std::size_t               _size  = 0;
+
+    const const_buffer* _data() const noexcept {
+        return _count > inline_capacity ? _spilled.data() : _inline.data();
+    }
+
+public:
+    void clear() noexcept {
+        _spilled.clear();
+        _count = 0;
+        _size  = 0;
+    }
+
+    void reserve(std::size_t n_bufs) {
+        if (n_bufs > inline_capacity) {
+            _spilled.reserve(n_bufs);
+        }
+    }
+
+    void append(const_buffer buf) {
+        if (buf.empty()) {
+            return;
+        }
+        if (_count < inline_capacity) {
+            _inline[_count] = buf;
+        } else {
+            if (_count == inline_capacity) {
+                _spilled.assign(_inline.begin(), _inline.end());
+            }
+            _spilled.push_back(buf);
+        }
+        ++_count;
+        _size += buf.size();
+    }
+
+    /// The exact total number of bytes in all buffers
+    std::size_t byte_size() const noexcept { return _size; }
+    /// The number of buffers (which is the number of iovecs required)
+    std::size_t count() const noexcept { return _count; }
+
+    auto begin() const noexcept { return _data(); }
+    auto end() const noexcept { return _data() + _count; }
+
+    /**
+     * Fill an array of `iovec` (or any struct with `iov_base` and `iov_len` members) with the
+     * buffers. Returns the number of entries filled, which is at most `max`.
+     */
+    template <typename IoVec>
+    std::size_t fill_iovecs(IoVec* out, std::size_t max) const noexcept {
+        auto n = count() < max ? count() : max;
+        auto bufs = _data();
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i].iov_base = const_cast<std::byte*>(bufs[i].data());
+            out[i].iov_len  = bufs[i].size();
+        }
+        return n;
+    }
+
+    /// Copy all of the bytes into `out`, which must be at least byte_size() bytes
+    mutable_buffer copy_to(mutable_buffer out) const noexcept {
+        neo_assert(expects,
+                   out.size() >= byte_size(),
+                   "Output buffer is too small for the gathered message",
+                   out.size(),
+                   byte_size());
+        for (auto buf : *this) {
+            out += buffer_copy(out, buf);
+        }
+        return out;
+    }
+};
+
+/// Append the header fields and the empty line that ends a message head
+template <typename Headers>
+void gather_header_fields(gather_buffers& out, const Headers& headers) {
+    using namespace gather_detail;
+    for (const auto& [key, value] : headers) {
+        out.append(const_buffer(as_buffer(key)));
+        out.append(static_buf(colon_sp, 2));
+        out.append(const_buffer(as_buffer(value)));
+        out.append(static_buf(crlf, 2));
+    }
+    out.append(static_buf(crlf, 2));
+}
+
+template <typename Headers>
+void gather_request_head(gather_buffers& out, const request_line& line, const Headers& headers) {
+    using namespace gather_detail;
+    out.append(const_buffer(line.method_view));
+    out.append(static_buf(space, 1));
+    out.append(const_buffer(line.target.path_view));
+    if (line.target.has_query) {
+        out.append(static_buf(query_sep, 1));
+        out.append(const_buffer(line.target.query_view));
+    }
+    out.append(static_buf(space, 1));
+    out.append(version_buf(line.http_version));
+    out.append(static_buf(crlf, 2));
+    gather_header_fields(out, headers);
+}
+
+template <typename Headers>
+void gather_response_head(gather_buffers& out, const status_line& line, const Headers& headers) {
+    using namespace gather_detail;
+    neo_assert(expects, line.valid(), "Cannot gather an invalid status line", line.status);
+    if (auto whole_line = line.prerendered(); !whole_line.empty()) {
+        out.append(whole_line);
+        gather_header_fields(out, headers);
+        return;
+    }
+    out.append(version_buf(line.http_version));
+    out.append(static_buf(space, 1));
+    out.append(static_buf(status_digits.data() + (line.status - 100) * 3, 3));
+    out.append(static_buf(space, 1));
+    out.append(const_buffer(line.phrase_view));
+    out.append(static_buf(crlf, 2));
+    gather_header_fields(out, headers);
+}
+
+}  // namespace neo::http
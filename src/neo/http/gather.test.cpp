@@ -0,0 +1,104 @@
+#include <neo/http/gather.hpp>
+#include <neo/http/headers.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace {
+struct fake_iovec {
+    void*       iov_base;
+    std::size_t iov_len;
+};
+}  // namespace
+
+TEST_CASE("Gather a request head") {
+    neo::http::headers hds;
+    hds.add("Host", "example.com");
+    hds.add("Accept", "*/*");
+
+    neo::http::request_line line;
+    line.method_view       = "GET";
+    line.target.path_view  = "/search";
+    line.target.has_query  = true;
+    line.target.query_view = "q=1";
+    line.http_version      = neo::http::version::v1_1;
+
+    neo::http::gather_buffers bufs;
+    neo::http::gather_request_head(bufs, line, hds);
+
+    std::string_view expect
+        = "GET /search?q=1 HTTP/1.1\r\n"
+          "Host: example.com\r\n"
+          "Accept: */*\r\n"
+          "\r\n";
+    CHECK(bufs.byte_size() == expect.size());
+
+    std::string flat(bufs.byte_size(), '\0');
+    bufs.copy_to(neo::mutable_buffer(flat));
+    CHECK(flat == expect);
+
+    // The header values are not copied
+    auto found = std::find_if(bufs.begin(), bufs.end(), [&](auto buf) {
+        return buf.data() == neo::const_buffer(hds["Host"].value).data();
+    });
+    CHECK(found != bufs.end());
+
+    std::array<fake_iovec, 64> iovs;
+    auto                       n_iov = bufs.fill_iovecs(iovs.data(), iovs.size());
+    CHECK(n_iov == bufs.count());
+    std::string from_iovs;
+    for (auto i = 0u; i < n_iov; ++i) {
+        from_iovs.append(static_cast<const char*>(iovs[i].iov_base), iovs[i].iov_len);
+    }
+    CHECK(from_iovs == expect);
+}
+
+TEST_CASE("Gather a response head") {
+    neo::http::headers hds;
+    hds.add("Content-Length", "0");
+
+    neo::http::gather_buffers bufs;
+    for (int code : {100, 204, 404, 599, 999}) {
+        neo::http::status_line line;
+        line.http_version = neo::http::version::v1_0;
+        line.status       = code;
+        line.phrase_view  = "Phrase";
+        bufs.clear();
+        neo::http::gather_response_head(bufs, line, hds);
+        std::string flat(bufs.byte_size(), '\0');
+        bufs.copy_to(neo::mutable_buffer(flat));
+        CHECK(flat
+              == "HTTP/1.0 " + std::to_string(code)
+                  + " Phrase\r\n"
+                    "Content-Length: 0\r\n"
+                    "\r\n");
+    }
+}
+
+TEST_CASE("Gather more buffers than are stored inline") {
+    neo::http::headers hds;
+    std::string        expect = "HTTP/1.1 200 OK\r\n";
+    for (int n = 0; n < 40; ++n) {
+        auto key = "X-Field-" + std::to_string(n);
+        hds.add(key, std::to_string(n));
+        expect += key + ": " + std::to_string(n) + "\r\n";
+    }
+    expect += "\r\n";
+
+    neo::http::gather_buffers bufs;
+    for (int round = 0; round < 2; ++round) {
+        bufs.clear();
+        neo::http::gather_response_head(bufs,
+                                        neo::http::status_line{neo::http::version::v1_1,
+                                                               200,
+                                                               "OK"},
+                                        hds);
+        CHECK(bufs.count() > neo::http::gather_buffers::inline_capacity);
+        std::string flat(bufs.byte_size(), '\0');
+        bufs.copy_to(neo::mutable_buffer(flat));
+        CHECK(flat == expect);
+    }
+}
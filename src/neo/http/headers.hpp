@@ -1,10 +1,19 @@
 #pragma once
 
+#include <neo/http/parse/header_id.hpp>
+
 #include <neo/assert.hpp>
 #include <neo/opt_ref.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace neo::http {
@@ -28,6 +37,48 @@ constexpr bool header_key_equivalent(std::string_view key1, std::string_view key
     return true;
 }
 
+/**
+ * A header field in a basic_headers. The value may be changed, but the key may not, since the
+ * container indexes its items by their keys.
+ *
+ * An item can be unpacked like a pair, as in `auto& [key, value] = item`, where `key` is const.
+ */
+template <typename String>
+class basic_header_item {
+    String _key;
+
+public:
+    String value;
+
+    basic_header_item(String key, String value_)
+        : _key(std::move(key))
+        , value(std::move(value_)) {}
+
+    const String& key() const noexcept { return _key; }
+
+    bool key_equal(std::string_view other) const noexcept {
+        return header_key_equivalent(_key, other);
+    }
+
+    template <std::size_t I>
+    decltype(auto) get() const noexcept {
+        if constexpr (I == 0) {
+            return (_key);
+        } else {
+            return (value);
+        }
+    }
+
+    template <std::size_t I>
+    decltype(auto) get() noexcept {
+        if constexpr (I == 0) {
+            return std::as_const(_key);
+        } else {
+            return (value);
+        }
+    }
+};
+
 template <typename Allocator = std::allocator<void>>
 class basic_headers {
 public:
@@ -37,28 +88,89 @@ public:
         std::char_traits<char>,
         typename std::allocator_traits<allocator_type>::template rebind_alloc<char>>;
 
-    struct header_item {
-        string_type key;
-        string_type value;
-
-        bool key_equal(std::string_view other) const noexcept {
-            return header_key_equivalent(key, other);
-        }
-    };
+    using header_item = basic_header_item<string_type>;
 
 private:
-    allocator_type _alloc{};
-    std::vector<header_item,
-                typename std::allocator_traits<allocator_type>::template rebind_alloc<header_item>>
-        _vec{_alloc};
+    template <typename T>
+    using rebind_vector
+        = std::vector<T, typename std::allocator_traits<allocator_type>::template rebind_alloc<T>>;
+
+    allocator_type            _alloc{};
+    rebind_vector<header_item> _vec{_alloc};
+    // The header_id of each item in `_vec`
+    rebind_vector<header_id> _ids{_alloc};
+    // For each header_id, one more than the index of the first item with that id, or zero.
+    std::array<std::uint32_t, header_id_detail::count> _first_index = {};
+
+    template <typename Self>
+    static auto _find(Self& self, header_id id) noexcept {
+        auto idx = self._first_index[static_cast<std::size_t>(id)];
+        return idx == 0 ? self.end() : self.begin() + (idx - 1);
+    }
 
     template <typename Self>
     static auto _find(Self& self, std::string_view key) noexcept {
-        return std::find_if(self.begin(), self.end(), [&](const header_item& cand) {
-            return cand.key_equal(key);
-        });
+        if (auto id = classify_header(key); id != header_id::unknown) {
+            return _find(self, id);
+        }
+        // Only unknown headers need a string comparison
+        for (std::size_t i = 0; i < self._ids.size(); ++i) {
+            if (self._ids[i] == header_id::unknown && self._vec[i].key_equal(key)) {
+                return self.begin() + i;
+            }
+        }
+        return self.end();
     }
 
+    template <typename Self, typename... Keys>
+    static auto _find_many(Self& self, const Keys&... keys) noexcept {
+        using item_type = std::remove_reference_t<decltype(*self.begin())>;
+        std::array<header_id, sizeof...(Keys)>             ids = {_key_id(keys)...};
+        std::array<std::string_view, sizeof...(Keys)>      strs = {_key_str(keys)...};
+        std::array<opt_ref<item_type>, sizeof...(Keys)> ret;
+
+        bool any_unknown = false;
+        for (std::size_t k = 0; k < ids.size(); ++k) {
+            if (ids[k] != header_id::unknown) {
+                auto found = _find(self, ids[k]);
+                if (found != self.end()) {
+                    ret[k] = *found;
+                }
+            } else {
+                any_unknown = any_unknown || !strs[k].empty();
+            }
+        }
+        if (!any_unknown) {
+            return ret;
+        }
+        // Resolve every remaining key in a single pass over the unknown headers
+        for (std::size_t i = 0; i < self._ids.size(); ++i) {
+            if (self._ids[i] != header_id::unknown) {
+                continue;
+            }
+            for (std::size_t k = 0; k < ids.size(); ++k) {
+                if (ids[k] == header_id::unknown && !ret[k] && self._vec[i].key_equal(strs[k])) {
+                    ret[k] = self._vec[i];
+                }
+            }
+        }
+        return ret;
+    }
+
+    template <typename Key>
+    static auto _as_key(const Key& key) noexcept {
+        if constexpr (std::is_same_v<Key, header_id>) {
+            return key;
+        } else {
+            return std::string_view(key);
+        }
+    }
+
+    static header_id _key_id(header_id id) noexcept { return id; }
+    static header_id _key_id(std::string_view key) noexcept { return classify_header(key); }
+    static std::string_view _key_str(header_id) noexcept { return {}; }
+    static std::string_view _key_str(std::string_view key) noexcept { return key; }
+
 public:
     basic_headers() = default;
     explicit basic_headers(allocator_type alloc) noexcept
@@ -66,9 +178,24 @@ public:
 
     allocator_type get_allocator() const noexcept { return _alloc; }
 
+    /// Append a header field. The returned reference may be used to modify the value.
     header_item& add(std::string_view key, std::string_view val) noexcept {
-        return _vec.emplace_back(
-            header_item{string_type{key, get_allocator()}, string_type{val, get_allocator()}});
+        return add(classify_header(key), key, val);
+    }
+
+    /**
+     * Append a header field whose key is already known to be classified as `id`, such as a field
+     * from a parsed message head. This is not checked, since checking would classify the key
+     * again. A wrong `id` makes find() give wrong answers.
+     */
+    header_item& add(header_id id, std::string_view key, std::string_view val) noexcept {
+        auto& slot = _first_index[static_cast<std::size_t>(id)];
+        if (slot == 0 && id != header_id::unknown) {
+            slot = static_cast<std::uint32_t>(_vec.size() + 1);
+        }
+        _ids.push_back(id);
+        return _vec.emplace_back(string_type{key, get_allocator()},
+                                 string_type{val, get_allocator()});
     }
 
     using iterator       = header_item*;
@@ -84,6 +211,11 @@ public:
     auto end() const noexcept { return begin() + size(); }
     auto cend() const noexcept { return end; }
 
+    /// The header_id of the item at `it`
+    header_id id_of(const_iterator it) const noexcept {
+        return _ids[static_cast<std::size_t>(it - begin())];
+    }
+
     opt_ref<header_item> find(std::string_view key) noexcept {
         auto found = _find(*this, key);
         return found == end() ? std::nullopt : opt_ref(*found);
@@ -94,6 +226,30 @@ public:
         return found == end() ? std::nullopt : opt_ref(*found);
     }
 
+    opt_ref<header_item> find(header_id id) noexcept {
+        auto found = _find(*this, id);
+        return found == end() ? std::nullopt : opt_ref(*found);
+    }
+
+    opt_ref<const header_item> find(header_id id) const noexcept {
+        auto found = _find(*this, id);
+        return found == end() ? std::nullopt : opt_ref(*found);
+    }
+
+    /**
+     * Look up several headers at once. Each key is a `header_id` or a string. The result is an
+     * array of `opt_ref`, one for each key, in the same order.
+     */
+    template <typename... Keys>
+    auto find_many(const Keys&... keys) noexcept {
+        return _find_many(*this, _as_key(keys)...);
+    }
+
+    template <typename... Keys>
+    auto find_many(const Keys&... keys) const noexcept {
+        return _find_many(*this, _as_key(keys)...);
+    }
+
     header_item& operator[](std::string_view key) noexcept {
         auto found = find(key);
         neo_assert(expects, found != std::nullopt, "Request for non-existent header", key);
@@ -109,4 +265,18 @@ public:
 
 using headers = basic_headers<>;
 
-}  // namespace neo::http
\ No newline at end of file
+}  // namespace neo::http
+
+template <typename String>
+struct std::tuple_size<neo::http::basic_header_item<String>>
+    : std::integral_constant<std::size_t, 2> {};
+
+template <typename String>
+struct std::tuple_element<0, neo::http::basic_header_item<String>> {
+    using type = const String;
+};
+
+template <typename String>
+struct std::tuple_element<1, neo::http::basic_header_item<String>> {
+    using type = String;
+};
\ No newline at end of file
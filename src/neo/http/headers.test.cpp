@@ -2,6 +2,9 @@
 
 #include <catch2/catch.hpp>
 
+#include <string>
+#include <type_traits>
+
 TEST_CASE("Create a simple headers container") {
     neo::http::headers hds;
     hds.add("Content-Type", "bunch-o-bytes");
@@ -13,3 +16,82 @@ TEST_CASE("Create a simple headers container") {
 
     CHECK_FALSE(hds.find("Transport-Encoding"));
 }
+
+TEST_CASE("Classify standard header names") {
+    using neo::http::header_id;
+    static_assert(neo::http::classify_header("Content-Length") == header_id::content_length);
+    CHECK(neo::http::classify_header("content-length") == header_id::content_length);
+    CHECK(neo::http::classify_header("TRANSFER-ENCODING") == header_id::transfer_encoding);
+    CHECK(neo::http::classify_header("TE") == header_id::te);
+    CHECK(neo::http::classify_header("X-Custom-Thing") == header_id::unknown);
+    CHECK(neo::http::classify_header("Content_Length") == header_id::unknown);
+    CHECK(neo::http::classify_header("") == header_id::unknown);
+    CHECK(neo::http::header_name(header_id::www_authenticate) == "WWW-Authenticate");
+
+    // Every standard name maps back to its own id
+    for (auto i = 1u; i < neo::http::header_id_detail::count; ++i) {
+        auto id = static_cast<header_id>(i);
+        CAPTURE(neo::http::header_name(id));
+        CHECK(neo::http::classify_header(neo::http::header_name(id)) == id);
+    }
+}
+
+TEST_CASE("Find headers by id") {
+    using neo::http::header_id;
+    neo::http::headers hds;
+    hds.add("X-Thing", "1");
+    hds.add("content-length", "42");
+    hds.add("Set-Cookie", "a=b");
+    hds.add("Set-Cookie", "c=d");
+    hds.add("X-Other", "2");
+
+    CHECK(hds.id_of(hds.begin()) == header_id::unknown);
+    CHECK(hds.id_of(hds.begin() + 1) == header_id::content_length);
+
+    REQUIRE(hds.find(header_id::content_length));
+    CHECK(hds.find(header_id::content_length)->value == "42");
+    CHECK(hds.find(header_id::set_cookie)->value == "a=b");
+    CHECK_FALSE(hds.find(header_id::transfer_encoding));
+    CHECK(hds["X-OTHER"].value == "2");
+
+    auto [clen, te, other, thing, missing] = hds.find_many(header_id::content_length,
+                                                           header_id::transfer_encoding,
+                                                           "x-other",
+                                                           std::string_view("X-Thing"),
+                                                           "X-Missing");
+    REQUIRE(clen);
+    CHECK(clen->value == "42");
+    CHECK_FALSE(te);
+    REQUIRE(other);
+    CHECK(other->value == "2");
+    REQUIRE(thing);
+    CHECK(thing->value == "1");
+    CHECK_FALSE(missing);
+}
+
+TEST_CASE("Header keys cannot be changed in place") {
+    using neo::http::header_id;
+    neo::http::headers hds;
+    hds.add("Content-Length", "42");
+    hds.add("X-Thing", "1");
+
+    auto& item = *hds.begin();
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(item.key())>>);
+    item.value = "43";
+    CHECK(hds.find(header_id::content_length)->value == "43");
+
+    std::string text;
+    for (auto& [key, value] : hds) {
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(key)>>);
+        text += key + ": " + value + "\n";
+        value += "!";
+    }
+    CHECK(text == "Content-Length: 43\nX-Thing: 1\n");
+    CHECK(hds["x-thing"].value == "1!");
+    CHECK(hds["x-thing"].key() == "X-Thing");
+
+    // Copies keep their index
+    neo::http::headers copy;
+    copy = hds;
+    CHECK(copy.find(header_id::content_length)->value == "43!");
+}
@@ -0,0 +1,272 @@
+#include "./latency.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+using namespace neo;
+using namespace neo::http;
+
+namespace {
+
+static_assert(latency_histogram::bucket_index(31) == 31);
+static_assert(latency_histogram::bucket_index(32) == 32);
+static_assert(latency_histogram::bucket_index(64) == 64);
+static_assert(latency_histogram::bucket_max(latency_histogram::bucket_index(1000)) >= 1000);
+static_assert(latency_histogram::bucket_index(std::uint64_t(-1))
+              == latency_histogram::n_buckets - 1);
+
+/// The histograms of one thread. Only that thread records into them.
+class thread_histograms {
+    // Allocated on first use, since most combinations are never seen
+    std::array<std::atomic<latency_histogram*>, n_latency_histograms> _hists = {};
+    // Whether the registry knows of us. If not, nothing we record could be read.
+    bool _registered = false;
+
+public:
+    thread_histograms() noexcept;
+    ~thread_histograms();
+
+    void record(const latency_sample& s) noexcept {
+        if (!_registered) {
+            return;
+        }
+        auto  idx  = latency_snapshot::index(s.op, s.framing, classify_head_size(s.head_size));
+        auto* hist = _hists[idx].load(std::memory_order_relaxed);
+        if (!hist) {
+            hist = new (std::nothrow) latency_histogram;
+            if (!hist) {
+                return;
+            }
+            _hists[idx].store(hist, std::memory_order_release);
+        }
+        hist->record(static_cast<std::uint64_t>(s.duration.count()));
+    }
+
+    void snapshot_into(std::array<histogram_snapshot, n_latency_histograms>& out) const {
+        for (auto i = 0u; i < n_latency_histograms; ++i) {
+            if (auto hist = _hists[i].load(std::memory_order_acquire)) {
+                out[i].merge(hist->snapshot());
+            }
+        }
+    }
+};
+
+struct registry {
+    std::mutex                                           mutex;
+    std::vector<const thread_histograms*>                live;
+    std::array<histogram_snapshot, n_latency_histograms> retired;
+
+    static registry& get() {
+        // Never destroyed, so threads may exit during static destruction
+        static auto* inst = new registry;
+        return *inst;
+    }
+};
+
+thread_histograms::thread_histograms() noexcept {
+    // This is constructed from the recording hook, which must never throw. If we can't register,
+    // this thread just doesn't record.
+    try {
+        auto&            reg = registry::get();
+        std::unique_lock lk{reg.mutex};
+        reg.live.push_back(this);
+        _registered = true;
+    } catch (...) {
+    }
+}
+
+thread_histograms::~thread_histograms() {
+    if (_registered) {
+        auto&            reg = registry::get();
+        std::unique_lock lk{reg.mutex};
+        reg.live.erase(std::find(reg.live.begin(), reg.live.end(), this));
+        // Keep what this thread recorded, unless we are out of memory to do so
+        try {
+            snapshot_into(reg.retired);
+        } catch (...) {
+        }
+    }
+    for (auto& hist : _hists) {
+        delete hist.load(std::memory_order_relaxed);
+    }
+}
+
+}  // namespace
+
+std::string_view http::to_string(latency_op op) noexcept {
+    switch (op) {
+    case latency_op::read_response_head:
+        return "read_response_head";
+    case latency_op::read_response_body:
+        return "read_response_body";
+    case latency_op::write_request:
+        return "write_request";
+    }
+    return "?";
+}
+
+std::string_view http::to_string(body_framing fr) noexcept {
+    switch (fr) {
+    case body_framing::unknown:
+        return "unknown";
+    case body_framing::none:
+        return "none";
+    case body_framing::length:
+        return "length";
+    case body_framing::chunked:
+        return "chunked";
+    case body_framing::other_coding:
+        return "other_coding";
+    }
+    return "?";
+}
+
+std::string_view http::to_string(head_size_class sz) noexcept {
+    switch (sz) {
+    case head_size_class::lt256:
+        return "lt256";
+    case head_size_class::lt1k:
+        return "lt1k";
+    case head_size_class::lt4k:
+        return "lt4k";
+    case head_size_class::lt16k:
+        return "lt16k";
+    case head_size_class::ge16k:
+        return "ge16k";
+    }
+    return "?";
+}
+
+void histogram_snapshot::merge(const histogram_snapshot& other) {
+    if (other._counts.empty()) {
+        return;
+    }
+    if (_counts.empty()) {
+        _counts.resize(latency_histogram::n_buckets);
+    }
+    for (auto i = 0u; i < _counts.size(); ++i) {
+        _counts[i] += other._counts[i];
+    }
+    _count += other._count;
+    _sum += other._sum;
+    _max = (std::max)(_max, other._max);
+}
+
+std::uint64_t histogram_snapshot::value_at_quantile(double q) const noexcept {
+    if (_count == 0) {
+        return 0;
+    }
+    q         = std::clamp(q, 0.0, 1.0);
+    auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(_count)));
+    rank      = (std::max)(rank, std::uint64_t(1));
+
+    std::uint64_t seen = 0;
+    for (auto i = 0u; i < _counts.size(); ++i) {
+        seen += _counts[i];
+        if (seen >= rank) {
+            return (std::min)(latency_histogram::bucket_max(i), _max);
+        }
+    }
+    return _max;
+}
+
+void latency_histogram::record(std::uint64_t value) noexcept {
+    _counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+    auto prev_max = _max.load(std::memory_order_relaxed);
+    while (value > prev_max
+           && !_max.compare_exchange_weak(prev_max, value, std::memory_order_relaxed)) {
+    }
+}
+
+histogram_snapshot latency_histogram::snapshot() const {
+    histogram_snapshot ret;
+    ret._count = _count.load(std::memory_order_relaxed);
+    if (ret._count == 0) {
+        return ret;
+    }
+    ret._counts.resize(n_buckets);
+    // The buckets are read one at a time while they may be recorded into, so recount the total
+    // rather than trust _count to match them.
+    ret._count = 0;
+    for (auto i = 0u; i < n_buckets; ++i) {
+        ret._counts[i] = _counts[i].load(std::memory_order_relaxed);
+        ret._count += ret._counts[i];
+    }
+    ret._sum = _sum.load(std::memory_order_relaxed);
+    ret._max = _max.load(std::memory_order_relaxed);
+    return ret;
+}
+
+histogram_snapshot latency_snapshot::total(latency_op op) const {
+    histogram_snapshot ret;
+    auto               begin = index(op, body_framing{}, head_size_class{});
+    for (auto i = 0u; i < n_body_framings * n_head_size_classes; ++i) {
+        ret.merge(_hists[begin + i]);
+    }
+    return ret;
+}
+
+std::string latency_snapshot::to_text() const {
+    std::string ret;
+    for (auto op = 0u; op < n_latency_ops; ++op) {
+        for (auto fr = 0u; fr < n_body_framings; ++fr) {
+            for (auto sz = 0u; sz < n_head_size_classes; ++sz) {
+                auto& hist = get(latency_op(op), body_framing(fr), head_size_class(sz));
+                if (hist.count() == 0) {
+                    continue;
+                }
+                std::string labels = "op=\"";
+                labels.append(to_string(latency_op(op)))
+                    .append("\",framing=\"")
+                    .append(to_string(body_framing(fr)))
+                    .append("\",head_size=\"")
+                    .append(to_string(head_size_class(sz)))
+                    .append("\"");
+                for (auto [q, q_str] : {std::pair{0.5, "0.5"},
+                                        std::pair{0.99, "0.99"},
+                                        std::pair{0.999, "0.999"}}) {
+                    ret.append("neo_http_latency_ns{")
+                        .append(labels)
+                        .append(",quantile=\"")
+                        .append(q_str)
+                        .append("\"} ")
+                        .append(std::to_string(hist.value_at_quantile(q)))
+                        .append("\n");
+                }
+                ret.append("neo_http_latency_ns_count{")
+                    .append(labels)
+                    .append("} ")
+                    .append(std::to_string(hist.count()))
+                    .append("\n");
+                ret.append("neo_http_latency_ns_sum{")
+                    .append(labels)
+                    .append("} ")
+                    .append(std::to_string(hist.sum()))
+                    .append("\n");
+            }
+        }
+    }
+    return ret;
+}
+
+void http::record_latency(const latency_sample& sample) noexcept {
+    thread_local thread_histograms hists;
+    hists.record(sample);
+}
+
+latency_snapshot http::snapshot_latencies() {
+    latency_snapshot ret;
+    auto&            reg = registry::get();
+    std::unique_lock lk{reg.mutex};
+    for (auto i = 0u; i < n_latency_histograms; ++i) {
+        ret._hists[i].merge(reg.retired[i]);
+    }
+    for (auto thr : reg.live) {
+        thr->snapshot_into(ret._hists);
+    }
+    return ret;
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "./parse/framing.hpp"
+#include "./parse/stats.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neo::http {
+
+/// The operations whose latency can be recorded
+enum class latency_op {
+    /// Reading a response head (read_response_head(), or the head in read_response())
+    read_response_head,
+    /// Transferring a response body in read_response()
+    read_response_body,
+    /// Writing a request head and body with write_request()
+    write_request,
+};
+
+/// How a message body was framed, as far as the operation could tell
+enum class body_framing {
+    /// The framing was not determined
+    unknown,
+    /// No Content-Length or Transfer-Encoding
+    none,
+    length,
+    chunked,
+    /// A Transfer-Encoding that does not end in chunked
+    other_coding,
+};
+
+/// Buckets of message head sizes, for splitting latencies by how much there was to parse
+enum class head_size_class {
+    lt256,
+    lt1k,
+    lt4k,
+    lt16k,
+    ge16k,
+};
+
+constexpr std::size_t n_latency_ops        = 3;
+constexpr std::size_t n_body_framings      = 5;
+constexpr std::size_t n_head_size_classes  = 5;
+constexpr std::size_t n_latency_histograms = n_latency_ops * n_body_framings * n_head_size_classes;
+
+std::string_view to_string(latency_op) noexcept;
+std::string_view to_string(body_framing) noexcept;
+std::string_view to_string(head_size_class) noexcept;
+
+constexpr head_size_class classify_head_size(std::size_t size) noexcept {
+    return size < 256        ? head_size_class::lt256
+        : size < 1024        ? head_size_class::lt1k
+        : size < 4 * 1024    ? head_size_class::lt4k
+        : size < 16 * 1024   ? head_size_class::lt16k
+                             : head_size_class::ge16k;
+}
+
+constexpr body_framing classify_framing(const message_framing& framing) noexcept {
+    if (framing.has_transfer_encoding()) {
+        return framing.chunked ? body_framing::chunked : body_framing::other_coding;
+    } else if (framing.has_content_length) {
+        return body_framing::length;
+    }
+    return body_framing::none;
+}
+
+/// The time taken by one operation
+struct latency_sample {
+    latency_op               op;
+    body_framing             framing;
+    std::size_t              head_size;
+    std::chrono::nanoseconds duration;
+};
+
+/**
+ * An immutable copy of the counts in a latency_histogram. Snapshots can be merged, such as to
+ * combine the histograms of several threads.
+ */
+class histogram_snapshot {
+    // Empty if no values have been recorded
+    std::vector<std::uint64_t> _counts;
+    std::uint64_t              _count = 0;
+    std::uint64_t              _sum   = 0;
+    std::uint64_t              _max   = 0;
+
+    friend class latency_histogram;
+
+public:
+    std::uint64_t count() const noexcept { return _count; }
+    std::uint64_t sum() const noexcept { return _sum; }
+    std::uint64_t max() const noexcept { return _max; }
+
+    void merge(const histogram_snapshot& other);
+
+    /**
+     * The smallest value that at least `q` (in [0, 1]) of the recorded values are at or below,
+     * to within the precision of the histogram's buckets. Zero if there are no values.
+     */
+    std::uint64_t value_at_quantile(double q) const noexcept;
+};
+
+/**
+ * A histogram of nanosecond durations, with buckets whose width grows with their value (as in
+ * HdrHistogram), so every value is counted with a relative error of at most 1/32. Values above
+ * about 18 minutes are counted as 2^40 ns.
+ *
+ * Recording is lock-free, and a snapshot may be taken while other threads are recording.
+ */
+class latency_histogram {
+public:
+    static constexpr int         sub_bucket_bits = 5;
+    static constexpr int         max_value_bits  = 40;
+    static constexpr std::size_t n_buckets = std::size_t(max_value_bits - sub_bucket_bits + 1)
+        << sub_bucket_bits;
+
+    static constexpr std::size_t bucket_index(std::uint64_t value) noexcept {
+        constexpr std::uint64_t max_value = (std::uint64_t(1) << max_value_bits) - 1;
+        if (value > max_value) {
+            value = max_value;
+        }
+        if (value < (std::uint64_t(1) << sub_bucket_bits)) {
+            return static_cast<std::size_t>(value);
+        }
+        int msb = 63;
+        while (!(value >> msb)) {
+            --msb;
+        }
+        auto shift = msb - sub_bucket_bits;
+        auto sub   = (value >> shift) & ((std::uint64_t(1) << sub_bucket_bits) - 1);
+        return (std::size_t(shift + 1) << sub_bucket_bits) + static_cast<std::size_t>(sub);
+    }
+
+    /// The largest value that is counted in the bucket at `index`
+    static constexpr std::uint64_t bucket_max(std::size_t index) noexcept {
+        if (index < (std::size_t(1) << sub_bucket_bits)) {
+            return index;
+        }
+        auto shift = static_cast<int>(index >> sub_bucket_bits) - 1;
+        auto sub   = index & ((std::size_t(1) << sub_bucket_bits) - 1);
+        auto low   = ((std::uint64_t(1) << sub_bucket_bits) + sub) << shift;
+        return low + (std::uint64_t(1) << shift) - 1;
+    }
+
+    void record(std::uint64_t value) noexcept;
+
+    histogram_snapshot snapshot() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, n_buckets> _counts = {};
+    std::atomic<std::uint64_t>                         _count{0};
+    std::atomic<std::uint64_t>                         _sum{0};
+    std::atomic<std::uint64_t>                         _max{0};
+};
+
+/// A merged snapshot of the latencies recorded by every thread, by operation, framing, and size
+class latency_snapshot {
+    std::array<histogram_snapshot, n_latency_histograms> _hists;
+
+    friend latency_snapshot snapshot_latencies();
+
+public:
+    static constexpr std::size_t index(latency_op op, body_framing fr, head_size_class sz) {
+        return (static_cast<std::size_t>(op) * n_body_framings + static_cast<std::size_t>(fr))
+            * n_head_size_classes
+            + static_cast<std::size_t>(sz);
+    }
+
+    const histogram_snapshot& get(latency_op op, body_framing fr, head_size_class sz) const {
+        return _hists[index(op, fr, sz)];
+    }
+
+    /// The latencies of `op` for every framing and head size, merged together
+    histogram_snapshot total(latency_op op) const;
+
+    /**
+     * Render the p50, p99, and p999 latencies, count, and sum of every non-empty histogram, one
+     * per line, in the Prometheus text exposition format:
+     *
+     *     neo_http_latency_ns{op="...",framing="...",head_size="...",quantile="0.99"} 1234
+     */
+    std::string to_text() const;
+};
+
+/**
+ * Record a sample in the calling thread's histograms. The first call on each thread registers
+ * that thread's histograms, which takes a lock. Later calls are lock-free.
+ */
+void record_latency(const latency_sample& sample) noexcept;
+
+/// Merge the histograms of every thread, including threads that have exited
+latency_snapshot snapshot_latencies();
+
+/**
+ * A statistics policy (see no_parse_stats) that records the latency of operations with
+ * record_latency(), and counts nothing else.
+ */
+struct thread_latency_stats : no_parse_stats {
+    static void on_latency(const latency_sample& sample) noexcept { record_latency(sample); }
+};
+
+namespace detail {
+
+template <typename Stats>
+concept records_latency = requires(const latency_sample& sample) {
+    Stats::on_latency(sample);
+};
+
+/// Times an operation for `Stats`, if it records latencies. Otherwise does nothing.
+template <typename Stats>
+class latency_timer {
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point _start;
+
+public:
+    latency_timer() noexcept {
+        if constexpr (records_latency<Stats>) {
+            _start = clock::now();
+        }
+    }
+
+    /// Report the time since construction (or the last restart())
+    void record(latency_op op, body_framing framing, std::size_t head_size) noexcept {
+        if constexpr (records_latency<Stats>) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now()
+                                                                                - _start);
+            Stats::on_latency(latency_sample{op, framing, head_size, elapsed});
+        }
+    }
+
+    void restart() noexcept {
+        if constexpr (records_latency<Stats>) {
+            _start = clock::now();
+        }
+    }
+
+    /**
+     * The framing of a message that is written with the given header fields, which are a range of
+     * key-value pairs. The fields are only examined if `Stats` records latencies.
+     */
+    template <typename Headers>
+    static body_framing framing_of(const Headers& headers) noexcept {
+        if constexpr (records_latency<Stats>) {
+            message_framing framing;
+            for (const auto& [key, value] : headers) {
+                header_bufs field{std::string_view(key), std::string_view(value)};
+                field.id = classify_header(field.key_view);
+                framing.add_field(field);
+            }
+            return classify_framing(framing);
+        } else {
+            return body_framing::unknown;
+        }
+    }
+};
+
+}  // namespace detail
+
+}  // namespace neo::http
@@ -0,0 +1,114 @@
+#include <neo/http/latency.hpp>
+
+#include <neo/http/request.hpp>
+#include <neo/http/response.hpp>
+
+#include <neo/string_io.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+
+using neo::http::latency_histogram;
+using neo::http::latency_op;
+
+TEST_CASE("Histogram buckets are precise to within 1/32") {
+    for (std::uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull}) {
+        auto idx = latency_histogram::bucket_index(value);
+        auto max = latency_histogram::bucket_max(idx);
+        CHECK(max >= value);
+        CHECK(max - value <= value / 32);
+        if (idx != 0) {
+            CHECK(latency_histogram::bucket_max(idx - 1) < value);
+        }
+    }
+}
+
+TEST_CASE("Take quantiles from a histogram") {
+    latency_histogram hist;
+    CHECK(hist.snapshot().value_at_quantile(0.5) == 0);
+    for (std::uint64_t n = 1; n <= 1000; ++n) {
+        hist.record(n * 1000);
+    }
+    auto snap = hist.snapshot();
+    CHECK(snap.count() == 1000);
+    CHECK(snap.sum() == 500'500'000);
+    CHECK(snap.max() == 1'000'000);
+    CHECK(snap.value_at_quantile(0.5) == Approx(500'000).epsilon(1.0 / 32));
+    CHECK(snap.value_at_quantile(0.99) == Approx(990'000).epsilon(1.0 / 32));
+    CHECK(snap.value_at_quantile(1.0) == 1'000'000);
+
+    latency_histogram other;
+    other.record(5'000'000);
+    snap.merge(other.snapshot());
+    CHECK(snap.count() == 1001);
+    CHECK(snap.max() == 5'000'000);
+    CHECK(snap.value_at_quantile(1.0) == 5'000'000);
+}
+
+TEST_CASE("Record the latency of reading and writing messages") {
+    auto before = neo::http::snapshot_latencies();
+
+    std::thread([] {
+        using stats = neo::http::thread_latency_stats;
+        neo::http::read_response_head<neo::http::simple_response, stats>(
+            neo::const_buffer("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nHello"));
+
+        neo::string_dynbuf_io out;
+        neo::http::read_response<stats>(
+            out,
+            neo::const_buffer("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                              "5\r\nHello\r\n0\r\n\r\n"));
+        CHECK(out.read_area_view() == "Hello");
+
+        neo::string_dynbuf_io req_out;
+        neo::http::write_request<stats>(req_out,
+                                        neo::http::request_line::parse(
+                                            neo::const_buffer("GET / HTTP/1.1\r\n")),
+                                        neo::http::headers{},
+                                        neo::const_buffer());
+
+        neo::http::headers post_headers;
+        post_headers.add("Content-Length", "5");
+        neo::http::write_request<stats>(req_out,
+                                        neo::http::request_line::parse(
+                                            neo::const_buffer("POST / HTTP/1.1\r\n")),
+                                        post_headers,
+                                        neo::const_buffer("Hello"));
+
+        neo::http::headers put_headers;
+        put_headers.add("transfer-encoding", "gzip, chunked");
+        neo::http::write_request<stats>(req_out,
+                                        neo::http::request_line::parse(
+                                            neo::const_buffer("PUT / HTTP/1.1\r\n")),
+                                        put_headers,
+                                        neo::const_buffer("0\r\n\r\n"));
+    }).join();
+
+    // The thread has exited, but what it recorded is kept
+    auto after = neo::http::snapshot_latencies();
+    auto count = [](auto& snap, auto op, auto framing) {
+        return snap.get(op, framing, neo::http::head_size_class::lt256).count();
+    };
+    using fr = neo::http::body_framing;
+    CHECK(count(after, latency_op::read_response_head, fr::length)
+          == count(before, latency_op::read_response_head, fr::length) + 1);
+    CHECK(count(after, latency_op::read_response_head, fr::chunked)
+          == count(before, latency_op::read_response_head, fr::chunked) + 1);
+    CHECK(count(after, latency_op::read_response_body, fr::chunked)
+          == count(before, latency_op::read_response_body, fr::chunked) + 1);
+    CHECK(after.total(latency_op::write_request).count()
+          == before.total(latency_op::write_request).count() + 3);
+    CHECK(count(after, latency_op::write_request, fr::none)
+          == count(before, latency_op::write_request, fr::none) + 1);
+    CHECK(count(after, latency_op::write_request, fr::length)
+          == count(before, latency_op::write_request, fr::length) + 1);
+    CHECK(count(after, latency_op::write_request, fr::chunked)
+          == count(before, latency_op::write_request, fr::chunked) + 1);
+
+    auto text = after.to_text();
+    CHECK_THAT(text,
+               Catch::Contains("neo_http_latency_ns{op=\"read_response_body\",framing=\"chunked\","
+                               "head_size=\"lt256\",quantile=\"0.99\"} "));
+    CHECK_THAT(text, Catch::Contains("neo_http_latency_ns_count{op=\"write_request\""));
+}
@@ -0,0 +1,73 @@
+#include "./mapped_file.hpp"
+
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace neo;
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::system_category(), what);
+}
+
+}  // namespace
+
+void http::mapped_file::_unmap() noexcept {
+    if (_data) {
+        ::munmap(const_cast<std::byte*>(_data), _size);
+        _data = nullptr;
+        _size = 0;
+    }
+}
+
+http::mapped_file::mapped_file(int fd, mapped_file_hints hints) {
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0) {
+        throw_errno("neo::http failed to stat a file to map");
+    }
+    if (st.st_size == 0) {
+        // There is nothing to map
+        return;
+    }
+    auto size = static_cast<std::size_t>(st.st_size);
+    auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        throw_errno("neo::http failed to map a file");
+    }
+    _data = static_cast<const std::byte*>(addr);
+    _size = size;
+
+    // These are only hints, so we don't care if they fail
+    if (hints.sequential) {
+        ::madvise(addr, size, MADV_SEQUENTIAL);
+    }
+#if defined(MADV_HUGEPAGE)
+    if (hints.huge_pages) {
+        ::madvise(addr, size, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+http::mapped_file::mapped_file(const std::filesystem::path& path, mapped_file_hints hints) {
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw_errno("neo::http failed to open a file to map");
+    }
+    try {
+        *this = mapped_file(fd, hints);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+#endif
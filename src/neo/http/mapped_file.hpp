@@ -0,0 +1,111 @@
+#pragma once
+
+#if !defined(_WIN32)
+
+#include <neo/assert.hpp>
+#include <neo/const_buffer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+
+namespace neo::http {
+
+/// Hints for how a mapped_file will be read
+struct mapped_file_hints {
+    /// The file will be read from front to back, so the kernel should read ahead aggressively
+    bool sequential = true;
+    /// Back the mapping with huge pages if the system supports it for this file
+    bool huge_pages = false;
+};
+
+/**
+ * A read-only memory mapping of an entire file, for use as a message body.
+ *
+ * The contents are available as a single const_buffer, so the file can be written to a sink
+ * without first being read into an intermediate buffer. Use size() for the Content-Length.
+ */
+class mapped_file {
+    const std::byte* _data = nullptr;
+    std::size_t      _size = 0;
+
+    void _unmap() noexcept;
+
+public:
+    mapped_file() = default;
+
+    /// Map the file open as `fd`. The descriptor is not owned, and may be closed afterwards.
+    explicit mapped_file(int fd, mapped_file_hints hints = {});
+    /// Open and map the file at `path`
+    explicit mapped_file(const std::filesystem::path& path, mapped_file_hints hints = {});
+
+    mapped_file(mapped_file&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            _unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_file() { _unmap(); }
+
+    /// The size of the file, which is the Content-Length of a body made from it
+    std::size_t size() const noexcept { return _size; }
+
+    const_buffer bytes() const noexcept { return const_buffer(_data, _size); }
+};
+
+/**
+ * A buffer_source that reads a mapped_file one window at a time. Each window is a view of the
+ * mapping, so nothing is copied until the caller copies it to a sink.
+ *
+ * The source refers to the mapped_file, which must outlive it.
+ */
+class mapped_file_source {
+    const mapped_file* _file   = nullptr;
+    std::size_t        _pos    = 0;
+    std::size_t        _window = default_window_size;
+
+public:
+    static constexpr std::size_t default_window_size = 1024 * 1024;
+
+    mapped_file_source() = default;
+    explicit mapped_file_source(const mapped_file& file,
+                                std::size_t        window_size = default_window_size)
+        : _file(&file)
+        , _window(window_size) {
+        // With an empty window, next() would never hand out the remaining bytes
+        neo_assert(expects,
+                   window_size != 0,
+                   "The window of a mapped_file_source must not be empty",
+                   window_size);
+    }
+
+    /// The number of bytes that have not been consumed
+    std::uint64_t remaining() const noexcept { return _file->size() - _pos; }
+
+    const_buffer next(std::size_t n) const noexcept {
+        auto avail = _file->bytes() + _pos;
+        return avail.first((std::min)({n, _window, avail.size()}));
+    }
+
+    void consume(std::size_t n) noexcept {
+        neo_assert(expects,
+                   n <= remaining(),
+                   "Cannot consume more bytes than remain in a mapped_file_source",
+                   n,
+                   remaining());
+        _pos += n;
+    }
+};
+
+}  // namespace neo::http
+
+#endif
@@ -0,0 +1,79 @@
+#include <neo/http/mapped_file.hpp>
+
+#if !defined(_WIN32)
+
+#include <neo/http/request.hpp>
+
+#include <neo/string_io.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+namespace {
+
+struct temp_file {
+    std::FILE* file = std::tmpfile();
+
+    explicit temp_file(std::string_view content) {
+        REQUIRE(file);
+        REQUIRE(std::fwrite(content.data(), 1, content.size(), file) == content.size());
+        std::fflush(file);
+    }
+    ~temp_file() { std::fclose(file); }
+
+    int fd() const noexcept { return ::fileno(file); }
+};
+
+}  // namespace
+
+TEST_CASE("Map a file") {
+    temp_file              tmp{"Hello, file!"};
+    neo::http::mapped_file file{tmp.fd(), {.sequential = true, .huge_pages = true}};
+    CHECK(file.size() == 12);
+    CHECK(std::string_view(file.bytes()) == "Hello, file!");
+
+    auto moved = std::move(file);
+    CHECK(file.size() == 0);
+    CHECK(std::string_view(moved.bytes()) == "Hello, file!");
+}
+
+TEST_CASE("Map an empty file") {
+    temp_file              tmp{""};
+    neo::http::mapped_file file{tmp.fd()};
+    CHECK(file.size() == 0);
+    CHECK(file.bytes().empty());
+}
+
+TEST_CASE("Fail to map a file that does not exist") {
+    CHECK_THROWS(neo::http::mapped_file{std::filesystem::path("/this/file/does/not/exist")});
+}
+
+TEST_CASE("Write a request with a mapped file body") {
+    std::string content;
+    for (int n = 0; content.size() < 100'000; ++n) {
+        content += std::to_string(n) + "\n";
+    }
+    temp_file              tmp{content};
+    neo::http::mapped_file file{tmp.fd()};
+
+    neo::http::mapped_file_source body{file, 4096};
+    CHECK(body.remaining() == content.size());
+    CHECK(body.next(100'000).size() == 4096);
+
+    neo::http::headers headers;
+    headers.add("Content-Length", std::to_string(file.size()));
+    auto req_line = neo::http::request_line::parse(neo::const_buffer("PUT /f HTTP/1.1\r\n"));
+    neo::string_dynbuf_io out;
+    neo::http::write_request(out, req_line, headers, body);
+    CHECK(body.remaining() == 0);
+    CHECK(out.read_area_view()
+          == "PUT /f HTTP/1.1\r\nContent-Length: " + std::to_string(content.size()) + "\r\n\r\n"
+              + content);
+}
+
+#endif
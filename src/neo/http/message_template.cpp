@@ -0,0 +1,77 @@
+#include "./message_template.hpp"
+
+#include "./parse/token.hpp"
+
+#include <stdexcept>
+
+using neo::http::message_template_builder;
+
+namespace {
+
+void check_token(std::string_view str, const char* message) {
+    auto tok = neo::http::token::parse_next(neo::const_buffer(str));
+    if (!tok.valid() || !tok.parse_tail.empty()) {
+        throw std::invalid_argument(message);
+    }
+}
+
+}  // namespace
+
+message_template_builder& message_template_builder::append(std::string_view text) {
+    _text.append(text);
+    return *this;
+}
+
+message_template_builder& message_template_builder::hole() {
+    if (_tmpl._n_holes == message_template::max_holes) {
+        throw std::length_error("Too many holes in neo::http::message_template");
+    }
+    _tmpl._holes[_tmpl._n_holes++] = static_cast<std::uint32_t>(_text.size());
+    return *this;
+}
+
+message_template_builder& message_template_builder::start_line(const status_line& line) {
+    neo_assert(expects, line.valid(), "Cannot use an invalid status line in a template");
+    _text.resize(_text.size() + line.required_write_size());
+    line.write(mutable_buffer(_text) + (_text.size() - line.required_write_size()));
+    return *this;
+}
+
+message_template_builder& message_template_builder::start_line(const request_line& line) {
+    neo_assert(expects, line.valid(), "Cannot use an invalid request line in a template");
+    auto prev_size = _text.size();
+    _text.resize(prev_size + line.byte_size());
+    line.write(mutable_buffer(_text) + prev_size);
+    return *this;
+}
+
+message_template_builder&
+message_template_builder::request_line_with_target_hole(std::string_view method,
+                                                        http::version    ver) {
+    check_token(method, "Invalid request method for message_template");
+    append(method).append(" ").hole().append(" ");
+    append(std::string_view(version_buf(ver))).append("\r\n");
+    return *this;
+}
+
+message_template_builder& message_template_builder::add(std::string_view key,
+                                                          std::string_view value) {
+    check_token(key, "Invalid header field name for message_template");
+    if (!is_safe_field_value(value)) {
+        throw std::invalid_argument(
+            "Header field value for message_template contains a control character");
+    }
+    append(key).append(": ").append(value).append("\r\n");
+    return *this;
+}
+
+message_template_builder& message_template_builder::add_hole(std::string_view key) {
+    check_token(key, "Invalid header field name for message_template");
+    append(key).append(": ").hole().append("\r\n");
+    return *this;
+}
+
+neo::http::owned_message_template message_template_builder::build() const {
+    auto text = _text + "\r\n";
+    return owned_message_template(std::move(text), _tmpl);
+}
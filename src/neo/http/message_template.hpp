@@ -0,0 +1,231 @@
+#pragma once
+
+#include "./gather.hpp"
+#include "./parse/request.hpp"
+#include "./parse/status.hpp"
+#include "./version.hpp"
+
+#include <neo/assert.hpp>
+#include <neo/buffer_algorithm/copy.hpp>
+#include <neo/const_buffer.hpp>
+#include <neo/mutable_buffer.hpp>
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace neo::http {
+
+/**
+ * Whether `value` can be placed in a message head as a header field value: it may not contain
+ * control characters (including CR and LF) other than HTAB (RFC 7230 section 3.2).
+ */
+constexpr bool is_safe_field_value(std::string_view value) noexcept {
+    for (char c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if ((byte < 0x20 && c != '\t') || byte == 0x7f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * A pre-rendered message head (or any other text) with holes for the parts that vary between
+ * messages, such as a Content-Length or a request target.
+ *
+ * A template can be written as a string literal at compile time, with each hole marked by `{}`:
+ *
+ *      constexpr message_template ok_text{
+ *          "HTTP/1.1 200 Okay\r\n"
+ *          "Content-Type: text/plain\r\n"
+ *          "Content-Length: {}\r\n"
+ *          "\r\n"};
+ *
+ * or built at runtime with a message_template_builder. Emitting a message copies (or gathers)
+ * the fixed text and the hole values in order, without looking at the header fields. The hole
+ * values are checked with is_safe_field_value(), so a value cannot inject a line into the head.
+ * A value that fills a request target must not contain spaces either, which is not checked.
+ *
+ * A message_template does not own its text.
+ */
+class message_template {
+public:
+    static constexpr std::size_t max_holes = 16;
+
+private:
+    std::string_view                     _text;
+    std::array<std::uint32_t, max_holes> _holes   = {};
+    std::size_t                          _n_holes = 0;
+    // The number of bytes of `_text` that mark each hole
+    std::size_t _marker_size = 0;
+
+    friend class owned_message_template;
+    friend class message_template_builder;
+
+    constexpr std::string_view _segment(std::size_t idx) const noexcept {
+        auto begin = idx == 0 ? 0 : _holes[idx - 1] + _marker_size;
+        auto end   = idx == _n_holes ? _text.size() : _holes[idx];
+        return _text.substr(begin, end - begin);
+    }
+
+    void _check_count(std::size_t n_values) const noexcept {
+        neo_assert(expects,
+                   n_values == _n_holes,
+                   "Wrong number of values given to fill a message_template",
+                   n_values,
+                   _n_holes);
+    }
+
+    void _check_values(std::initializer_list<std::string_view> values) const {
+        _check_count(values.size());
+        for (auto val : values) {
+            if (!is_safe_field_value(val)) {
+                throw std::invalid_argument(
+                    "Value for a neo::http::message_template contains a control character");
+            }
+        }
+    }
+
+public:
+    constexpr message_template() = default;
+
+    /**
+     * Create a template from text in which every `{}` marks a hole. Throws (or fails to compile,
+     * in a constant expression) if there are more than `max_holes` holes.
+     */
+    constexpr explicit message_template(std::string_view text)
+        : _text(text)
+        , _marker_size(2) {
+        for (auto pos = text.find("{}"); pos != text.npos; pos = text.find("{}", pos + 2)) {
+            if (_n_holes == max_holes) {
+                throw std::length_error("Too many holes in neo::http::message_template");
+            }
+            _holes[_n_holes++] = static_cast<std::uint32_t>(pos);
+        }
+    }
+
+    constexpr std::size_t hole_count() const noexcept { return _n_holes; }
+
+    /// The number of bytes of fixed text
+    constexpr std::size_t fixed_size() const noexcept {
+        return _text.size() - _n_holes * _marker_size;
+    }
+
+    /// The number of bytes in the message with the given hole values
+    std::size_t required_size(std::initializer_list<std::string_view> values) const noexcept {
+        _check_count(values.size());
+        auto ret = fixed_size();
+        for (auto val : values) {
+            ret += val.size();
+        }
+        return ret;
+    }
+
+    /**
+     * Write the message with the given hole values. `out` must have room for required_size().
+     * Throws std::invalid_argument if a value is not is_safe_field_value().
+     */
+    mutable_buffer write(mutable_buffer out, std::initializer_list<std::string_view> values) const {
+        _check_values(values);
+        neo_assert(expects,
+                   out.size() >= required_size(values),
+                   "Output buffer is too small for the message_template",
+                   out.size(),
+                   required_size(values));
+        auto val_it = values.begin();
+        for (std::size_t idx = 0; idx < _n_holes; ++idx, ++val_it) {
+            out += buffer_copy(out, const_buffer(_segment(idx)));
+            out += buffer_copy(out, const_buffer(*val_it));
+        }
+        return out + buffer_copy(out, const_buffer(_segment(_n_holes)));
+    }
+
+    /**
+     * Append the buffers of the message to `out`, referring to the template text and to the
+     * given values (which must remain valid while `out` is in use). Throws
+     * std::invalid_argument if a value is not is_safe_field_value().
+     */
+    void gather(gather_buffers& out, std::initializer_list<std::string_view> values) const {
+        _check_values(values);
+        auto val_it = values.begin();
+        for (std::size_t idx = 0; idx < _n_holes; ++idx, ++val_it) {
+            out.append(const_buffer(_segment(idx)));
+            out.append(const_buffer(*val_it));
+        }
+        out.append(const_buffer(_segment(_n_holes)));
+    }
+};
+
+/// A message_template that owns its text. Created by message_template_builder.
+class owned_message_template {
+    std::string      _storage;
+    message_template _tmpl;
+
+    void _rebind() noexcept { _tmpl._text = _storage; }
+
+public:
+    owned_message_template() = default;
+    owned_message_template(std::string storage, const message_template& tmpl)
+        : _storage(std::move(storage))
+        , _tmpl(tmpl) {
+        _rebind();
+    }
+
+    owned_message_template(const owned_message_template& other)
+        : _storage(other._storage)
+        , _tmpl(other._tmpl) {
+        _rebind();
+    }
+
+    owned_message_template(owned_message_template&& other) noexcept
+        : _storage(std::move(other._storage))
+        , _tmpl(other._tmpl) {
+        _rebind();
+    }
+
+    owned_message_template& operator=(owned_message_template other) noexcept {
+        _storage.swap(other._storage);
+        _tmpl = other._tmpl;
+        _rebind();
+        return *this;
+    }
+
+    const message_template& get() const noexcept { return _tmpl; }
+    operator const message_template&() const noexcept { return get(); }
+    const message_template* operator->() const noexcept { return &_tmpl; }
+};
+
+/**
+ * Build a message_template at runtime. Header field keys and fixed values are validated once,
+ * here, so filling the template only has to check the hole values.
+ */
+class message_template_builder {
+    std::string      _text;
+    message_template _tmpl;
+
+public:
+    /// Append fixed text. This is not validated.
+    message_template_builder& append(std::string_view text);
+    /// Append a hole
+    message_template_builder& hole();
+
+    message_template_builder& start_line(const status_line& line);
+    message_template_builder& start_line(const request_line& line);
+    /// A request line whose target is a hole
+    message_template_builder& request_line_with_target_hole(std::string_view method,
+                                                            http::version    ver);
+
+    /// Add a header field with a fixed value, which must be is_safe_field_value()
+    message_template_builder& add(std::string_view key, std::string_view value);
+    /// Add a header field whose value is a hole
+    message_template_builder& add_hole(std::string_view key);
+
+    /// Add the empty line that ends the head, and create the template
+    owned_message_template build() const;
+};
+
+}  // namespace neo::http
@@ -0,0 +1,97 @@
+#include <neo/http/message_template.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace {
+
+constexpr neo::http::message_template ok_text{
+    "HTTP/1.1 200 Okay\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: {}\r\n"
+    "X-Request-Id: {}\r\n"
+    "\r\n"};
+
+static_assert(ok_text.hole_count() == 2);
+
+std::string fill(const neo::http::message_template&      tmpl,
+                 std::initializer_list<std::string_view> values) {
+    std::string ret(tmpl.required_size(values), '\0');
+    auto        rest = tmpl.write(neo::mutable_buffer(ret), values);
+    CHECK(rest.size() == 0);
+    return ret;
+}
+
+}  // namespace
+
+TEST_CASE("Fill a compile-time message template") {
+    CHECK(fill(ok_text, {"12", "abc-123"})
+          == "HTTP/1.1 200 Okay\r\n"
+             "Content-Type: text/plain\r\n"
+             "Content-Length: 12\r\n"
+             "X-Request-Id: abc-123\r\n"
+             "\r\n");
+
+    neo::http::gather_buffers bufs;
+    ok_text.gather(bufs, {"0", "x"});
+    CHECK(bufs.byte_size() == ok_text.fixed_size() + 2);
+    CHECK(bufs.count() == 5);
+}
+
+TEST_CASE("Build a message template at runtime") {
+    neo::http::message_template_builder builder;
+    builder.request_line_with_target_hole("GET", neo::http::version::v1_1)
+        .add("Host", "example.com")
+        .add_hole("X-Request-Id");
+    auto tmpl = builder.build();
+    CHECK(tmpl->hole_count() == 2);
+
+    // Copies own their own text
+    auto copy = tmpl;
+    tmpl      = {};
+    CHECK(fill(copy, {"/index.html", "42"})
+          == "GET /index.html HTTP/1.1\r\n"
+             "Host: example.com\r\n"
+             "X-Request-Id: 42\r\n"
+             "\r\n");
+
+    neo::http::status_line status{neo::http::version::v1_0, 404, "Not Found"};
+    auto not_found = neo::http::message_template_builder().start_line(status).build();
+    CHECK(fill(not_found, {}) == "HTTP/1.0 404 Not Found\r\n\r\n");
+
+    CHECK_THROWS(neo::http::message_template_builder().add("Bad Key", "x"));
+    CHECK_THROWS(neo::http::message_template_builder().add("Key", "x\r\nInjected: y"));
+    CHECK_THROWS(neo::http::message_template_builder().add("Key", std::string_view("x\0y", 3)));
+    CHECK_THROWS(neo::http::message_template_builder().add("Key", "x\x7f"));
+    CHECK_NOTHROW(neo::http::message_template_builder().add("Key", "x\ty"));
+}
+
+TEST_CASE("Build a message template from a request line") {
+    neo::http::request_line line;
+    line.method_view       = "POST";
+    line.target.path_view  = "/upload";
+    line.target.has_query  = true;
+    line.target.query_view = "name=a";
+    line.http_version      = neo::http::version::v1_1;
+
+    auto tmpl = neo::http::message_template_builder()
+                    .start_line(line)
+                    .add_hole("Content-Length")
+                    .build();
+    CHECK(fill(tmpl, {"5"})
+          == "POST /upload?name=a HTTP/1.1\r\n"
+             "Content-Length: 5\r\n"
+             "\r\n");
+}
+
+TEST_CASE("Hole values cannot inject lines into a message") {
+    std::string out(256, '\0');
+    CHECK_THROWS_AS(ok_text.write(neo::mutable_buffer(out), {"0\r\nInjected: yes", "x"}),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(ok_text.write(neo::mutable_buffer(out), {"0", "x\n"}), std::invalid_argument);
+
+    neo::http::gather_buffers bufs;
+    CHECK_THROWS_AS(ok_text.gather(bufs, {"0", "\x01"}), std::invalid_argument);
+    CHECK_NOTHROW(ok_text.gather(bufs, {"0", "a\tb"}));
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "./headers.hpp"
+
+#include <neo/assert.hpp>
+#include <neo/iterator_facade.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace neo::http {
+
+/// A header field as seen through a basic_packed_headers
+struct header_view {
+    std::string_view key;
+    std::string_view value;
+
+    bool key_equal(std::string_view other) const noexcept {
+        return header_key_equivalent(key, other);
+    }
+};
+
+/**
+ * A header container with the same interface as basic_headers, but which packs every key and
+ * value into a single contiguous byte arena.
+ *
+ * Each field is a small record of 32-bit offsets and lengths into the arena, so a message with
+ * any number of headers holds exactly two allocations (the arena and the record array), both
+ * obtained from `Allocator`. Iterating yields `header_view` objects. Views remain valid until the
+ * next call to add().
+ */
+template <typename Allocator = std::allocator<void>>
+class basic_packed_headers {
+public:
+    using allocator_type = Allocator;
+    using header_item    = header_view;
+
+private:
+    template <typename T>
+    using rebind_vector
+        = std::vector<T, typename std::allocator_traits<allocator_type>::template rebind_alloc<T>>;
+
+    struct record {
+        std::uint32_t offset;
+        std::uint32_t key_size;
+        std::uint32_t value_size;
+        header_id     id;
+    };
+
+    allocator_type        _alloc{};
+    rebind_vector<char>   _arena{_alloc};
+    rebind_vector<record> _records{_alloc};
+    // For each header_id, one more than the index of the first record with that id, or zero.
+    std::array<std::uint32_t, header_id_detail::count> _first_index = {};
+
+    header_view _view(const record& rec) const noexcept {
+        auto key = std::string_view(_arena.data() + rec.offset, rec.key_size);
+        return {key, std::string_view(key.data() + rec.key_size, rec.value_size)};
+    }
+
+    std::optional<header_view> _at(std::size_t idx) const noexcept {
+        if (idx >= _records.size()) {
+            return std::nullopt;
+        }
+        return _view(_records[idx]);
+    }
+
+    std::size_t _index_of(header_id id) const noexcept {
+        auto idx = _first_index[static_cast<std::size_t>(id)];
+        return idx == 0 ? size() : idx - 1;
+    }
+
+    std::size_t _index_of(std::string_view key) const noexcept {
+        if (auto id = classify_header(key); id != header_id::unknown) {
+            return _index_of(id);
+        }
+        for (std::size_t i = 0; i < _records.size(); ++i) {
+            if (_records[i].id == header_id::unknown && _view(_records[i]).key_equal(key)) {
+                return i;
+            }
+        }
+        return size();
+    }
+
+public:
+    basic_packed_headers() = default;
+    explicit basic_packed_headers(allocator_type alloc) noexcept
+        : _alloc(alloc) {}
+
+    allocator_type get_allocator() const noexcept { return _alloc; }
+
+    class iterator : public iterator_facade<iterator> {
+        const basic_packed_headers* _self = nullptr;
+        std::size_t                 _idx  = 0;
+
+    public:
+        iterator() = default;
+        iterator(const basic_packed_headers* self, std::size_t idx) noexcept
+            : _self(self)
+            , _idx(idx) {}
+
+        header_view dereference() const noexcept { return _self->_view(_self->_records[_idx]); }
+        void        increment() noexcept { ++_idx; }
+
+        /// The header_id of the current field
+        header_id id() const noexcept { return _self->_records[_idx].id; }
+
+        bool operator==(const iterator& other) const noexcept { return _idx == other._idx; }
+    };
+
+    using const_iterator = iterator;
+    using size_type      = std::size_t;
+
+    /// Reserve space for `n_headers` fields totalling `n_bytes` of key and value text
+    void reserve(size_type n_headers, size_type n_bytes) {
+        _records.reserve(n_headers);
+        _arena.reserve(n_bytes);
+    }
+
+    header_view add(std::string_view key, std::string_view val) {
+        return add(classify_header(key), key, val);
+    }
+
+    /**
+     * Append a header field whose key is already known to be classified as `id`. This is not
+     * checked, since checking would classify the key again. A wrong `id` makes find() give wrong
+     * answers.
+     */
+    header_view add(header_id id, std::string_view key, std::string_view val) {
+        neo_assert(expects,
+                   _arena.size() + key.size() + val.size()
+                       <= (std::numeric_limits<std::uint32_t>::max)(),
+                   "Too many header bytes for basic_packed_headers",
+                   _arena.size(),
+                   key.size(),
+                   val.size());
+        auto& slot = _first_index[static_cast<std::size_t>(id)];
+        if (slot == 0 && id != header_id::unknown) {
+            slot = static_cast<std::uint32_t>(_records.size() + 1);
+        }
+        auto offset = static_cast<std::uint32_t>(_arena.size());
+        _arena.insert(_arena.end(), key.begin(), key.end());
+        _arena.insert(_arena.end(), val.begin(), val.end());
+        _records.push_back(record{offset,
+                                  static_cast<std::uint32_t>(key.size()),
+                                  static_cast<std::uint32_t>(val.size()),
+                                  id});
+        return _view(_records.back());
+    }
+
+    size_type size() const noexcept { return _records.size(); }
+
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator cbegin() const noexcept { return begin(); }
+    iterator end() const noexcept { return iterator(this, size()); }
+    iterator cend() const noexcept { return end(); }
+
+    std::optional<header_view> find(std::string_view key) const noexcept {
+        return _at(_index_of(key));
+    }
+
+    std::optional<header_view> find(header_id id) const noexcept { return _at(_index_of(id)); }
+
+    /**
+     * Look up several headers at once. Each key is a `header_id` or a string. The result is an
+     * array of `std::optional<header_view>`, one for each key, in the same order.
+     */
+    template <typename... Keys>
+    auto find_many(const Keys&... keys) const noexcept {
+        std::array<std::optional<header_view>, sizeof...(Keys)> ret;
+        std::array<std::string_view, sizeof...(Keys)>            unknown_keys;
+
+        bool        any_unknown = false;
+        std::size_t k           = 0;
+        auto        one         = [&](const auto& key) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(key)>, header_id>) {
+                ret[k] = find(key);
+            } else if (auto id = classify_header(key); id != header_id::unknown) {
+                ret[k] = find(id);
+            } else {
+                unknown_keys[k] = key;
+                any_unknown     = true;
+            }
+            ++k;
+        };
+        (one(keys), ...);
+        if (!any_unknown) {
+            return ret;
+        }
+        // Resolve every remaining key in a single pass over the unknown headers
+        for (auto& rec : _records) {
+            if (rec.id != header_id::unknown) {
+                continue;
+            }
+            auto item = _view(rec);
+            for (k = 0; k < ret.size(); ++k) {
+                if (!ret[k] && !unknown_keys[k].empty() && item.key_equal(unknown_keys[k])) {
+                    ret[k] = item;
+                }
+            }
+        }
+        return ret;
+    }
+
+    header_view operator[](std::string_view key) const noexcept {
+        auto found = find(key);
+        neo_assert(expects, found != std::nullopt, "Request for non-existent header", key);
+        return *found;
+    }
+};
+
+using packed_headers = basic_packed_headers<>;
+
+}  // namespace neo::http
@@ -0,0 +1,68 @@
+#include <neo/http/packed_headers.hpp>
+#include <neo/http/response.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+TEST_CASE("Create a packed headers container") {
+    neo::http::packed_headers hds;
+    hds.add("Content-Type", "bunch-o-bytes");
+    hds.add("X-Thing", "Value");
+    hds.add("Content-Length", "12");
+
+    CHECK(hds.size() == 3);
+    CHECK(hds["Content-Type"].value == "bunch-o-bytes");
+    CHECK(hds["content-type"].value == "bunch-o-bytes");
+    CHECK(hds["x-THING"].value == "Value");
+    CHECK(hds.find(neo::http::header_id::content_length)->value == "12");
+    CHECK_FALSE(hds.find("Transport-Encoding"));
+
+    std::string joined;
+    for (const auto& [key, value] : hds) {
+        joined.append(key).append("=").append(value).append(";");
+    }
+    CHECK(joined == "Content-Type=bunch-o-bytes;X-Thing=Value;Content-Length=12;");
+
+    auto [clen, te, thing] = hds.find_many(neo::http::header_id::content_length,
+                                           neo::http::header_id::transfer_encoding,
+                                           "X-Thing");
+    REQUIRE(clen);
+    CHECK(clen->value == "12");
+    CHECK_FALSE(te);
+    REQUIRE(thing);
+    CHECK(thing->value == "Value");
+}
+
+TEST_CASE("Views into packed headers survive copying the container") {
+    neo::http::packed_headers hds;
+    for (int i = 0; i < 100; ++i) {
+        hds.add("X-Header-" + std::to_string(i), std::to_string(i * i));
+    }
+    auto copy = hds;
+    hds       = {};
+    CHECK(copy.size() == 100);
+    CHECK(copy["x-header-42"].value == "1764");
+    CHECK(copy.begin().id() == neo::http::header_id::unknown);
+}
+
+namespace {
+struct packed_response {
+    int                       status = 0;
+    std::string               status_message;
+    neo::http::version        version;
+    neo::http::packed_headers headers;
+    std::size_t               head_byte_size = 0;
+};
+}  // namespace
+
+TEST_CASE("Read a response head into packed headers") {
+    auto res = neo::http::read_response_head<packed_response>(
+        neo::const_buffer("HTTP/1.1 200 Okay\r\n"
+                          "Content-Length: 0\r\n"
+                          "Server: neo\r\n"
+                          "\r\n"));
+    CHECK(res.status == 200);
+    CHECK(res.headers.size() == 2);
+    CHECK(res.headers.find(neo::http::header_id::server)->value == "neo");
+}
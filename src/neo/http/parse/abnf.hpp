@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 // Refer: RFC7230, rfc5234, RFC3986
 
 /**
@@ -7,67 +10,85 @@
  */
 namespace neo::http::parse_detail {
 
-template <typename Left, typename Right>
-struct either {
-    constexpr static bool contains(char c) noexcept {
-        return Left::contains(c) || Right::contains(c);
-    }
+/**
+ * A set of byte values. Membership is stored as a 256-bit bitmap, so testing a character is a
+ * single table lookup regardless of how the class was composed.
+ *
+ * For the vectorized scanners (see scan.hpp) the class also carries a nibble table:
+ * `lo_nibbles[L]` has bit `H` set when the byte `(H << 4) | L` is a member. This only describes
+ * bytes below 0x80, which is fine because every HTTP character class is plain ASCII.
+ */
+struct char_class {
+    std::array<std::uint64_t, 4> bits       = {};
+    std::array<std::uint8_t, 16> lo_nibbles = {};
 
-    template <typename Other>
-    either<either, Other> operator|(Other) const noexcept {
-        return {};
+    constexpr bool contains(char c) const noexcept {
+        auto u = static_cast<unsigned char>(c);
+        return ((bits[u >> 6] >> (u & 63)) & 1) != 0;
     }
-};
 
-template <char... Cs>
-struct char_set_t {
-    constexpr static bool contains(char c) noexcept { return ((Cs == c) || ...); }
+    constexpr bool ascii_only() const noexcept { return bits[2] == 0 && bits[3] == 0; }
 
-    template <typename Other>
-    either<char_set_t, Other> operator|(Other) const noexcept {
-        return {};
+    constexpr char_class& insert(unsigned char u) noexcept {
+        bits[u >> 6] |= std::uint64_t(1) << (u & 63);
+        if (u < 0x80) {
+            lo_nibbles[u & 0xf] |= static_cast<std::uint8_t>(1 << (u >> 4));
+        }
+        return *this;
+    }
+
+    constexpr char_class operator|(const char_class& other) const noexcept {
+        char_class ret = *this;
+        for (auto i = 0u; i < bits.size(); ++i) {
+            ret.bits[i] |= other.bits[i];
+        }
+        for (auto i = 0u; i < lo_nibbles.size(); ++i) {
+            ret.lo_nibbles[i] |= other.lo_nibbles[i];
+        }
+        return ret;
     }
 };
 
 template <char... Cs>
-inline char_set_t<Cs...> char_set = {};
+inline constexpr char_class char_set = [] {
+    char_class ret;
+    (ret.insert(static_cast<unsigned char>(Cs)), ...);
+    return ret;
+}();
 
 template <char Min, char Max>
-struct char_range_t {
+inline constexpr char_class char_range = [] {
     static_assert(Min < Max);
-    constexpr static bool contains(char c) noexcept { return c >= Min && c <= Max; }
-
-    template <typename Other>
-    either<char_range_t, Other> operator|(Other) const noexcept {
-        return {};
+    char_class ret;
+    for (int c = static_cast<unsigned char>(Min); c <= static_cast<unsigned char>(Max); ++c) {
+        ret.insert(static_cast<unsigned char>(c));
     }
-};
-
-template <char Min, char Max>
-inline char_range_t<Min, Max> char_range = {};
+    return ret;
+}();
 
-inline auto HSPACE   = char_set<' ', '\t'>;
-inline auto BIT      = char_set<'0', '1'>;
-inline auto ANY_CHAR = char_range<'\x01', '\x7f'>;
-inline auto ALPHA    = char_range<'A', 'Z'> | char_range<'a', 'z'>;
-inline auto CTL      = char_range<'\x00', '\x1f'> | char_set<'\x7f'>;
-inline auto DIGIT    = char_range<'0', '9'>;
-inline auto DQUOTE   = char_set<'"'>;
-inline auto HEXDIG   = DIGIT | char_range<'A', 'F'>;
-inline auto HTAB     = char_set<'\t'>;
-inline auto LF       = char_set<'\n'>;
-inline auto SP       = char_set<' '>;
-inline auto VCHAR    = char_range<'\x21', '\x7e'>;
-inline auto WSP      = SP | HTAB;
-inline auto token_char
+inline constexpr auto HSPACE   = char_set<' ', '\t'>;
+inline constexpr auto BIT      = char_set<'0', '1'>;
+inline constexpr auto ANY_CHAR = char_range<'\x01', '\x7f'>;
+inline constexpr auto ALPHA    = char_range<'A', 'Z'> | char_range<'a', 'z'>;
+inline constexpr auto CTL      = char_range<'\x00', '\x1f'> | char_set<'\x7f'>;
+inline constexpr auto DIGIT    = char_range<'0', '9'>;
+inline constexpr auto DQUOTE   = char_set<'"'>;
+inline constexpr auto HEXDIG   = DIGIT | char_range<'A', 'F'>;
+inline constexpr auto HTAB     = char_set<'\t'>;
+inline constexpr auto LF       = char_set<'\n'>;
+inline constexpr auto SP       = char_set<' '>;
+inline constexpr auto VCHAR    = char_range<'\x21', '\x7e'>;
+inline constexpr auto WSP      = SP | HTAB;
+inline constexpr auto token_char
     = char_set<'!', '#', '$', '%', '&', '\'', '*', '+', '-', '.', '^', '_', '`', '|', '~'> | DIGIT
     | ALPHA;
 
-inline auto UNRESERVED = ALPHA | DIGIT | char_set<'-', '.', '_', '~'>;
-inline auto SUB_DELIMS = char_set<'!', '$', '&', '\'', '(', ')', '@', '*', '+', ',', ';', '='>;
+inline constexpr auto UNRESERVED = ALPHA | DIGIT | char_set<'-', '.', '_', '~'>;
+inline constexpr auto SUB_DELIMS
+    = char_set<'!', '$', '&', '\'', '(', ')', '@', '*', '+', ',', ';', '='>;
 
 // Path elements may also contain percent-encoded elements
-inline auto PCHAR_BASIC_CHARS = UNRESERVED | SUB_DELIMS | char_set<':', '@'>;
+inline constexpr auto PCHAR_BASIC_CHARS = UNRESERVED | SUB_DELIMS | char_set<':', '@'>;
 
 //    reserved      = gen-delims / sub-delims
 //    gen-delims    = ":" / "/" / "?" / "#" / "[" / "]" / "@"
@@ -1 +1,36 @@
-#include <neo/http/parse/abnf.hpp>
\ No newline at end of file
+#include <neo/http/parse/abnf.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string_view>
+
+using namespace neo::http::parse_detail;
+
+static_assert(DIGIT.contains('0'));
+static_assert(!DIGIT.contains('a'));
+static_assert(token_char.ascii_only());
+
+TEST_CASE("Character classes match their definitions") {
+    std::string_view separators = "()<>@,;:\\\"/[]?={} \t";
+    for (int i = 0; i < 256; ++i) {
+        auto c = static_cast<char>(i);
+        CAPTURE(i);
+        CHECK(VCHAR.contains(c) == (i >= 0x21 && i <= 0x7e));
+        CHECK(WSP.contains(c) == (c == ' ' || c == '\t'));
+        CHECK(CTL.contains(c) == (i < 0x20 || i == 0x7f));
+        CHECK(HEXDIG.contains(c) == ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F')));
+        CHECK(token_char.contains(c)
+              == (VCHAR.contains(c) && separators.find(c) == std::string_view::npos));
+    }
+}
+
+TEST_CASE("Nibble tables agree with the bitmap") {
+    const char_class* classes[] = {&token_char, &PCHAR_BASIC_CHARS, &CTL, &ANY_CHAR};
+    for (auto cls : classes) {
+        for (int i = 0; i < 0x80; ++i) {
+            CAPTURE(i);
+            bool in_nibbles = (cls->lo_nibbles[i & 0xf] >> (i >> 4)) & 1;
+            CHECK(in_nibbles == cls->contains(static_cast<char>(i)));
+        }
+    }
+}
@@ -2,25 +2,70 @@
 
 #include "./common.hpp"
 
-#include <charconv>
+#include "../trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 using namespace neo;
 
+namespace {
+
+constexpr std::uint8_t not_hex = 0xff;
+
+/// The value of each hex digit, or `not_hex`
+constexpr auto hex_digit_values = [] {
+    std::array<std::uint8_t, 256> ret = {};
+    for (auto& v : ret) {
+        v = not_hex;
+    }
+    for (int c = 0; c < 10; ++c) {
+        ret['0' + c] = static_cast<std::uint8_t>(c);
+    }
+    for (int c = 0; c < 6; ++c) {
+        ret['a' + c] = ret['A' + c] = static_cast<std::uint8_t>(10 + c);
+    }
+    return ret;
+}();
+
+constexpr std::uint8_t hex_value(std::byte b) noexcept {
+    return hex_digit_values[static_cast<std::uint8_t>(b)];
+}
+
+static_assert(hex_value(std::byte{'f'}) == 15);
+static_assert(hex_value(std::byte{'G'}) == not_hex);
+
+/// Shifting in another digit would overflow a chunk-size greater than this
+constexpr std::size_t max_size_before_digit = (std::numeric_limits<std::size_t>::max)() >> 4;
+
+}  // namespace
+
 http::chunk_head http::chunk_head::parse(const_buffer cb) noexcept {
     static chunk_head invalid_ret = {size_t(-1), const_buffer(), const_buffer()};
 
     std::size_t chunk_size = 0;
-    const auto  num_begin  = reinterpret_cast<const char*>(cb.data());
-    const auto  conv_res   = std::from_chars(num_begin, num_begin + cb.size(), chunk_size, 16);
+    auto        ptr        = cb.data();
+    const auto  end        = cb.data_end();
+    for (; ptr != end && hex_value(*ptr) != not_hex; ++ptr) {
+        if (chunk_size > max_size_before_digit) {
+            return invalid_ret;
+        }
+        chunk_size = (chunk_size << 4) | hex_value(*ptr);
+    }
 
-    if (conv_res.ec != std::errc{}) {
+    if (ptr == cb.data()) {
         return invalid_ret;
     }
 
-    cb += (conv_res.ptr - num_begin);
+    cb += static_cast<std::size_t>(ptr - cb.data());
     auto ext_full = cb;
 
-    while (!cb.empty() && !begins_with_crlf(cb)) {
+    // A chunk extension may not contain a CR, so the first one must begin the CRLF. This matches
+    // chunk_span_decoder.
+    while (!cb.empty() && cb.data()[0] != std::byte('\r')) {
         cb += 1;
     }
 
@@ -31,3 +76,155 @@ http::chunk_head http::chunk_head::parse(const_buffer cb) noexcept {
 
     return {chunk_size, ext_full.first(cb.data() - ext_full.data() - 2), cb};
 }
+
+http::dechunked_buffer http::dechunk_in_place(mutable_buffer buf) noexcept {
+    using status_t = dechunked_buffer::status_t;
+
+    auto out = buf.data();
+    auto in  = buf;
+    auto ret = [&](status_t st, mutable_buffer tail) {
+        return dechunked_buffer{st, buf.first(static_cast<std::size_t>(out - buf.data())), tail};
+    };
+
+    while (true) {
+        auto head = chunk_head::parse(in);
+        if (!head.valid()) {
+            // If there is a CRLF then we have the whole line, and it isn't a chunk head
+            return ret(find_crlf(in) < 0 ? status_t::incomplete : status_t::invalid, in);
+        }
+        auto head_size = static_cast<std::size_t>(head.parse_tail.data() - in.data());
+        auto rest      = in + head_size;
+
+        if (head.chunk_size == 0) {
+            // The last chunk. Skip the trailer fields.
+            if (begins_with_crlf(rest)) {
+                return ret(status_t::done, rest + 2);
+            }
+            auto trailer_end = find_crlfcrlf(rest);
+            if (trailer_end < 0) {
+                return ret(status_t::incomplete, in);
+            }
+            return ret(status_t::done, rest + (static_cast<std::size_t>(trailer_end) + 4));
+        }
+
+        if (rest.size() < 2 || rest.size() - 2 < head.chunk_size) {
+            return ret(status_t::incomplete, in);
+        }
+        if (!begins_with_crlf(rest + head.chunk_size)) {
+            return ret(status_t::invalid, in);
+        }
+        std::memmove(out, rest.data(), head.chunk_size);
+        out += head.chunk_size;
+        in = rest + (head.chunk_size + 2);
+    }
+}
+
+http::chunk_spans http::chunk_span_decoder::decode(const_buffer in,
+                                                   std::size_t  max_data) noexcept {
+    chunk_spans ret;
+    auto        ptr = in.data();
+    const auto  end = in.data_end();
+
+    auto expect = [&](char c, state_t next) {
+        _state = *ptr == std::byte(c) ? next : state_t::invalid;
+        ++ptr;
+    };
+    auto skip_line = [&](state_t next) {
+        ptr = std::find(ptr, end, std::byte('\r'));
+        if (ptr != end) {
+            _state = next;
+            ++ptr;
+        }
+    };
+
+    while (ptr != end) {
+        switch (_state) {
+        case state_t::data: {
+            if (ret.count == chunk_spans::max_spans || max_data == 0) {
+                // We have as much as we can return
+                ret.input_size = static_cast<std::size_t>(ptr - in.data());
+                return ret;
+            }
+            auto n = (std::min)({_size, static_cast<std::size_t>(end - ptr), max_data});
+            ret.buffers[ret.count]         = const_buffer(ptr, n);
+            ret.chunk_remaining[ret.count] = _size;
+            ++ret.count;
+            ptr += n;
+            max_data -= n;
+            _size -= n;
+            if (_size == 0) {
+                _state = state_t::data_cr;
+            }
+            break;
+        }
+        case state_t::data_cr:
+            expect('\r', state_t::data_lf);
+            break;
+        case state_t::data_lf:
+            expect('\n', state_t::head_start);
+            break;
+        case state_t::head_start:
+            if (hex_value(*ptr) == not_hex) {
+                _state = state_t::invalid;
+                break;
+            }
+            _size  = 0;
+            _state = state_t::size;
+            [[fallthrough]];
+        case state_t::size:
+            for (; ptr != end && hex_value(*ptr) != not_hex; ++ptr) {
+                if (_size > max_size_before_digit) {
+                    _state = state_t::invalid;
+                    break;
+                }
+                _size = (_size << 4) | hex_value(*ptr);
+            }
+            if (ptr != end && _state == state_t::size) {
+                // Anything else that precedes the CRLF is a chunk extension, which we ignore
+                _state = state_t::ext;
+            }
+            break;
+        case state_t::ext:
+            skip_line(state_t::head_lf);
+            break;
+        case state_t::head_lf:
+            expect('\n', _size == 0 ? state_t::trailer_start : state_t::data);
+            if (_state != state_t::invalid) {
+                ++ret.head_count;
+                NEO_HTTP_PROBE1(chunk_head, _size);
+            }
+            break;
+        case state_t::trailer_start:
+            if (_trailer_mode == trailer_mode::stop) {
+                // The caller reads the trailer section
+                ret.input_size = static_cast<std::size_t>(ptr - in.data());
+                return ret;
+            }
+            if (*ptr == std::byte('\r')) {
+                _state = state_t::final_lf;
+                ++ptr;
+            } else {
+                _state = state_t::trailer_line;
+            }
+            break;
+        case state_t::trailer_line:
+            skip_line(state_t::trailer_lf);
+            break;
+        case state_t::trailer_lf:
+            expect('\n', state_t::trailer_start);
+            break;
+        case state_t::final_lf:
+            expect('\n', state_t::done);
+            if (_state == state_t::done) {
+                NEO_HTTP_PROBE1(chunked_done, 0);
+            }
+            break;
+        case state_t::done:
+        case state_t::invalid:
+            ret.input_size = static_cast<std::size_t>(ptr - in.data());
+            return ret;
+        }
+    }
+    ret.input_size = static_cast<std::size_t>(ptr - in.data());
+    return ret;
+}
@@ -1,14 +1,23 @@
 #pragma once
 
 #include "./common.hpp"
+#include "./header.hpp"
+#include "./stats.hpp"
+#include "../trace.hpp"
 
 #include <neo/buffer_algorithm.hpp>
 #include <neo/buffer_source.hpp>
 #include <neo/bytewise_iterator.hpp>
 #include <neo/const_buffer.hpp>
+#include <neo/mutable_buffer.hpp>
 #include <neo/switch_coro.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 namespace neo::http {
 
@@ -32,7 +41,232 @@ struct chunk_head {
     constexpr bool valid() const noexcept { return chunk_size != size_t(-1); }
 };
 
-template <buffer_source InnerSource, std::size_t HeadMaxSize = 256>
+/// The result of dechunk_in_place()
+struct dechunked_buffer {
+    enum class status_t {
+        /// The entire chunked body was decoded
+        done,
+        /// The buffer ends before the end of the chunked body
+        incomplete,
+        /// The chunked body is malformed
+        invalid,
+    };
+
+    status_t status = status_t::invalid;
+    /// The decoded data, at the beginning of the input buffer
+    mutable_buffer body;
+    /**
+     * The bytes following the chunked body. If the body is incomplete or invalid, this begins at
+     * the first chunk that could not be decoded.
+     */
+    mutable_buffer tail;
+};
+
+/**
+ * Decode a chunked body that sits in a single buffer, in place. The data of each chunk is moved
+ * down over the chunk heads and delimiters that precede it, so the decoded body ends up
+ * contiguous at the beginning of `buf` without needing a second buffer. Chunk extensions and
+ * trailer fields are discarded.
+ *
+ * Only whole chunks are decoded. If `buf` ends in the middle of a chunk, the result is
+ * `incomplete`, and its `tail` begins at the head of that chunk.
+ */
+dechunked_buffer dechunk_in_place(mutable_buffer buf) noexcept;
+
+/**
+ * The chunk data found by one call to chunk_span_decoder::decode(). This is a buffer sequence
+ * of views into the decoded input.
+ */
+struct chunk_spans {
+    static constexpr std::size_t max_spans = 16;
+
+    std::array<const_buffer, max_spans> buffers;
+    /// For each buffer, the number of bytes of its chunk that remained where the buffer begins
+    std::array<std::size_t, max_spans> chunk_remaining;
+    /// The number of buffers
+    std::size_t count = 0;
+    /// The number of bytes of input that were decoded, including chunk heads and delimiters
+    std::size_t input_size = 0;
+    /// The number of chunk heads that were decoded, including the last chunk
+    std::size_t head_count = 0;
+
+    const const_buffer* begin() const noexcept { return buffers.data(); }
+    const const_buffer* end() const noexcept { return buffers.data() + count; }
+
+    std::size_t byte_size() const noexcept {
+        std::size_t ret = 0;
+        for (auto buf : *this) {
+            ret += buf.size();
+        }
+        return ret;
+    }
+};
+
+/**
+ * A resumable decoder for the chunked transfer-coding that walks as many chunk heads as it can
+ * find in one contiguous input buffer, and returns the data of all of those chunks at once.
+ *
+ * The decoder keeps its place between calls, including in the middle of a chunk head, so input
+ * buffers can be split anywhere and nothing needs to be copied aside.
+ *
+ * By default the trailer fields are skipped without being validated. A decoder made with
+ * `trailer_mode::stop` instead stops in the `trailer_start` state after the last chunk head,
+ * leaving the trailer section to the caller.
+ */
+class chunk_span_decoder {
+public:
+    enum class trailer_mode : std::uint8_t {
+        /// Skip the trailer section
+        skip,
+        /// Stop at the beginning of the trailer section
+        stop,
+    };
+
+    enum class state_t : std::uint8_t {
+        /// Expecting the first digit of a chunk-size
+        head_start,
+        /// Reading the digits of a chunk-size
+        size,
+        /// Skipping chunk extensions
+        ext,
+        /// Expecting the LF that ends a chunk head
+        head_lf,
+        /// Reading chunk data
+        data,
+        /// Expecting the CRLF that follows chunk data
+        data_cr,
+        data_lf,
+        /// At the beginning of a trailer field line, or the final CRLF
+        trailer_start,
+        /// Skipping a trailer field line
+        trailer_line,
+        trailer_lf,
+        /// Expecting the LF of the final CRLF
+        final_lf,
+        done,
+        invalid,
+    };
+
+private:
+    state_t      _state = state_t::head_start;
+    trailer_mode _trailer_mode = trailer_mode::skip;
+    // The size of the chunk-size being read, or the number of bytes of data remaining in a chunk
+    std::size_t _size = 0;
+
+public:
+    constexpr chunk_span_decoder() = default;
+    constexpr explicit chunk_span_decoder(trailer_mode mode) noexcept
+        : _trailer_mode(mode) {}
+
+    constexpr state_t state() const noexcept { return _state; }
+    constexpr bool    done() const noexcept { return _state == state_t::done; }
+    constexpr bool    invalid() const noexcept { return _state == state_t::invalid; }
+
+    /**
+     * Decode the chunked body in `in`, collecting at most `max_data` bytes of chunk data in at most
+     * chunk_spans::max_spans buffers. Stops at the end of the body, at the end of the input, or
+     * when it would need to collect more data.
+     */
+    chunk_spans decode(const_buffer in, std::size_t max_data) noexcept;
+
+    /// Resume the decoder inside of a chunk, with `remaining` bytes of the chunk left
+    constexpr void resume_data(std::size_t remaining) noexcept {
+        _state = remaining ? state_t::data : state_t::data_cr;
+        _size  = remaining;
+    }
+};
+
+namespace detail {
+
+/**
+ * The trailer section of a chunked body, copied out of the inner source of a chunked body
+ * decoder. The fields are validated with header_bufs::parse once the whole section is read.
+ */
+template <std::size_t MaxSize>
+class chunk_trailer_section {
+    std::array<std::byte, MaxSize> _bytes;
+    // The number of bytes in _bytes. Once read, this excludes the final CRLF.
+    std::size_t _size = 0;
+
+public:
+    /**
+     * Read the trailer section from `inner`, which must be just past the head of the last chunk.
+     * Exactly the bytes of the section are consumed, including the final CRLF. Returns false if
+     * `inner` ran out of bytes before the end of the section.
+     */
+    template <typename Inner>
+    bool try_read(Inner& inner) {
+        while (true) {
+            if (_size == MaxSize) {
+                throw std::runtime_error(
+                    "neo::http chunk decoder found a trailer section that is too large");
+            }
+            auto prev_size = _size;
+            auto n_copied  = buffer_copy(as_buffer(_bytes) + _size, inner.next(MaxSize - _size));
+            _size += n_copied;
+            if (n_copied == 0) {
+                return false;
+            }
+
+            auto        all = as_buffer(_bytes).first(_size);
+            std::size_t fields_size;
+            if (begins_with_crlf(all)) {
+                // There are no trailer fields
+                fields_size = 0;
+            } else if (auto end_pos = find_crlfcrlf(all); end_pos >= 0) {
+                // Keep the CRLF that ends the last field
+                fields_size = static_cast<std::size_t>(end_pos) + 2;
+            } else {
+                inner.consume(n_copied);
+                continue;
+            }
+            inner.consume(fields_size + 2 - prev_size);
+            _size = fields_size;
+            for (auto rest = bytes(); !rest.empty();) {
+                auto field = header_bufs::parse(rest);
+                if (!field.valid()) {
+                    throw std::runtime_error(
+                        "neo::http chunk decoder found an invalid trailer field");
+                }
+                rest = field.parse_tail;
+            }
+            return true;
+        }
+    }
+
+    const_buffer bytes() const noexcept { return as_buffer(_bytes, _size); }
+
+    auto fields() const noexcept {
+        return ad_hoc_range{header_iterator{bytes()}, header_iterator::sentinel_type{}};
+    }
+
+    template <typename Headers>
+    void copy_to(Headers& out) const {
+        for (auto& field : fields()) {
+            if constexpr (requires { out.add(field.id, "", ""); }) {
+                out.add(field.id, field.key_view, field.value_view);
+            } else {
+                out.add(field.key_view, field.value_view);
+            }
+        }
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Decode a chunked body from an inner source, handing out the data of one chunk at a time.
+ *
+ * The trailer section that follows the last chunk is kept in the object (so it can be at most
+ * `TrailerMaxSize` bytes) and is available from trailers() once the body is done.
+ *
+ * The work done to find chunk heads is reported to the statistics policy `Stats` (see
+ * no_parse_stats).
+ */
+template <buffer_source InnerSource,
+          std::size_t   HeadMaxSize    = 256,
+          std::size_t   TrailerMaxSize = 1024,
+          typename Stats               = no_parse_stats>
 class chunked_buffers {
 public:
     enum class state_t {
@@ -52,65 +286,92 @@ private:
     std::size_t _n_pending = 0;
     // Keep track of how many bytes remaining in the next chunk
     std::size_t _n_chunk_pending = 0;
+    // The trailer fields, copied out of the inner source
+    detail::chunk_trailer_section<TrailerMaxSize> _trailers;
     // Coroutine state
     int _coro_state = 0;
 
     auto _pending_buf() const noexcept { return as_buffer(_pending, _n_pending); }
 
+    // Whether the inner source hands out a single contiguous buffer, which we can parse in place
+    using _inner_next_t = decltype(std::declval<std::remove_cvref_t<InnerSource>&>().next(1));
+    static constexpr bool _inner_is_contiguous = std::is_convertible_v<_inner_next_t, const_buffer>;
+
     bool _try_read_chunk_trailer() {
-        /// XXX: Read more than just the CRLF at the end?
-        auto& inner        = next_layer();
-        auto  prev_pending = _n_pending;
-        auto  next_in      = inner.next(2);
-        auto  n_copied     = buffer_copy(as_buffer(_pending) + _n_pending, next_in);
-        _n_pending += n_copied;
-        if (n_copied == 0) {
-            // We didn't read anything from the stream
-            return false;
-        }
-        auto pbuf = _pending_buf();
-        if (begins_with_crlf(pbuf)) {
-            // We've found the CRLF at the end of the buffer
-            inner.consume(2 - prev_pending);
-            _n_pending = 0;
-            return true;
-        }
-        if (_n_pending >= 2) {
-            // We're never going to be able to parse enough to actually see it.
-            throw std::runtime_error(
-                "neo::http chunk decoder can't find an expected chunk trailer in the stream");
+        auto& inner = next_layer();
+        while (true) {
+            auto prev_pending = _n_pending;
+            auto next_in      = inner.next(2 - _n_pending);
+            auto n_copied     = buffer_copy(as_buffer(_pending) + _n_pending, next_in);
+            _n_pending += n_copied;
+            Stats::on_chunk_copied(n_copied);
+            if (n_copied == 0) {
+                // We didn't read anything from the stream
+                return false;
+            }
+            auto pbuf = _pending_buf();
+            if (begins_with_crlf(pbuf)) {
+                // We've found the CRLF at the end of the buffer
+                inner.consume(2 - prev_pending);
+                _n_pending = 0;
+                return true;
+            }
+            if (_n_pending >= 2) {
+                // We're never going to be able to parse enough to actually see it.
+                throw std::runtime_error(
+                    "neo::http chunk decoder can't find an expected chunk trailer in the stream");
+            }
+            inner.consume(n_copied);
         }
-        inner.consume(n_copied);
-        return _try_read_chunk_trailer();
     }
 
     bool _try_read_chunk_header() {
-        auto& inner        = next_layer();
-        auto  next_in      = inner.next(HeadMaxSize);
-        auto  prev_pending = _n_pending;
-        auto  n_copied     = buffer_copy(as_buffer(_pending) + _n_pending, next_in);
-        _n_pending += n_copied;
-        if (n_copied == 0) {
-            // Didn't read any more from the stream.
-            return false;
-        }
+        auto& inner = next_layer();
+        while (true) {
+            auto next_in = inner.next(HeadMaxSize);
+            if constexpr (_inner_is_contiguous) {
+                if (_n_pending == 0) {
+                    // Parse the head where it sits. We only need to copy it if it straddles the
+                    // buffers of the inner source.
+                    const_buffer in   = next_in;
+                    auto         head = chunk_head::parse(in);
+                    if (head.valid()) {
+                        Stats::on_chunk_head();
+                        NEO_HTTP_PROBE1(chunk_head, head.chunk_size);
+                        _n_chunk_pending = head.chunk_size;
+                        inner.consume(head.parse_tail.data() - in.data());
+                        return true;
+                    }
+                }
+            }
+            auto prev_pending = _n_pending;
+            auto n_copied     = buffer_copy(as_buffer(_pending) + _n_pending, next_in);
+            _n_pending += n_copied;
+            Stats::on_chunk_copied(n_copied);
+            if (n_copied == 0) {
+                // Didn't read any more from the stream.
+                return false;
+            }
 
-        auto pending_buffer = _pending_buf();
-        auto head           = chunk_head::parse(pending_buffer);
-        if (head.valid()) {
-            _n_pending       = 0;
-            _n_chunk_pending = head.chunk_size;
-            auto head_size   = head.parse_tail.data() - pending_buffer.data();
-            inner.consume(head_size - prev_pending);
-            return true;
-        }
-        if (_n_pending == HeadMaxSize) {
-            // We're never going to be able to parse enough to actually see it.
-            throw std::runtime_error(
-                "neo::http chunk decoder can't find the next chunk-head in the stream");
+            auto pending_buffer = _pending_buf();
+            auto head           = chunk_head::parse(pending_buffer);
+            if (head.valid()) {
+                Stats::on_chunk_head();
+                NEO_HTTP_PROBE1(chunk_head, head.chunk_size);
+                _n_pending       = 0;
+                _n_chunk_pending = head.chunk_size;
+                auto head_size   = head.parse_tail.data() - pending_buffer.data();
+                inner.consume(head_size - prev_pending);
+                return true;
+            }
+            if (_n_pending == HeadMaxSize) {
+                // We're never going to be able to parse enough to actually see it.
+                throw std::runtime_error(
+                    "neo::http chunk decoder can't find the next chunk-head in the stream");
+            }
+            Stats::on_chunk_head_retry();
+            inner.consume(n_copied);
         }
-        inner.consume(n_copied);
-        return _try_read_chunk_header();
     }
 
 public:
@@ -123,6 +384,21 @@ public:
 
     NEO_DECL_UNREF_GETTER(next_layer, _inner);
 
+    /// The bytes of the trailer fields, each ending with CRLF. Only meaningful once done().
+    const_buffer trailer_bytes() const noexcept { return _trailers.bytes(); }
+
+    /**
+     * The trailer fields, as a range of header_bufs that refer to this object. Only meaningful
+     * once done().
+     */
+    auto trailers() const noexcept { return _trailers.fields(); }
+
+    /// Add the trailer fields to `out`, which is a container like basic_headers
+    template <typename Headers>
+    void copy_trailers_to(Headers& out) const {
+        _trailers.copy_to(out);
+    }
+
     decltype(auto) next(std::size_t n) {
         auto& inner = next_layer();
 
@@ -134,10 +410,11 @@ public:
             }
 
             if (_n_chunk_pending == 0) {
-                while (!_try_read_chunk_trailer()) {
+                while (!_trailers.try_read(inner)) {
                     NEO_CORO_YIELD(inner.next(0));
                 }
                 _state = state_t::done;
+                NEO_HTTP_PROBE1(chunked_done, _trailers.bytes().size());
                 break;
             }
 
@@ -169,4 +446,148 @@ public:
 template <buffer_source S>
 explicit chunked_buffers(S &&) -> chunked_buffers<S>;
 
+/**
+ * A chunked body decoder for inner sources that hand out contiguous buffers. Unlike
+ * chunked_buffers, which returns the data of at most one chunk from each call to next(), this
+ * returns the data of every chunk it finds in the inner buffer as a chunk_spans sequence. This
+ * is much faster for bodies made of many small chunks.
+ *
+ * The trailer section is handled as by chunked_buffers: it is validated, kept in the object (so
+ * it can be at most `TrailerMaxSize` bytes), and is available from trailers() once the body is
+ * done.
+ *
+ * Each chunk head that is decoded is reported to the statistics policy `Stats`. A head that is
+ * walked again after a partial consume() is reported again.
+ */
+template <buffer_source InnerSource,
+          std::size_t   TrailerMaxSize = 1024,
+          typename Stats               = no_parse_stats>
+class chunked_span_buffers {
+    wrap_refs_t<InnerSource> _inner;
+
+    // The decoder state as of the bytes that have been consumed from the inner source
+    chunk_span_decoder _decoder{chunk_span_decoder::trailer_mode::stop};
+    // The decoder state at the end of the spans returned by the most recent call to next()
+    chunk_span_decoder _after = _decoder;
+    chunk_spans        _spans;
+    // The beginning of the inner buffer that _spans refers to
+    const std::byte* _in_begin = nullptr;
+    // The trailer fields, copied out of the inner source
+    detail::chunk_trailer_section<TrailerMaxSize> _trailers;
+    bool                                          _done = false;
+
+    // Read the trailer section once the decoder has stopped in front of it
+    bool _try_read_trailer_section() {
+        if (!_trailers.try_read(next_layer())) {
+            return false;
+        }
+        _done = true;
+        NEO_HTTP_PROBE1(chunked_done, _trailers.bytes().size());
+        return true;
+    }
+
+    // `n` plus a quarter, and a little more, without overflowing
+    static constexpr std::size_t _with_head_room(std::size_t n) noexcept {
+        constexpr auto max  = std::numeric_limits<std::size_t>::max();
+        auto           room = n / 4 + 64;
+        return n > max - room ? max : n + room;
+    }
+
+public:
+    chunked_span_buffers() = default;
+    explicit chunked_span_buffers(InnerSource&& src)
+        : _inner(NEO_FWD(src)) {}
+
+    constexpr bool done() const noexcept { return _done; }
+
+    NEO_DECL_UNREF_GETTER(next_layer, _inner);
+
+    /// The bytes of the trailer fields, each ending with CRLF. Only meaningful once done().
+    const_buffer trailer_bytes() const noexcept { return _trailers.bytes(); }
+
+    /**
+     * The trailer fields, as a range of header_bufs that refer to this object. Only meaningful
+     * once done().
+     */
+    auto trailers() const noexcept { return _trailers.fields(); }
+
+    /// Add the trailer fields to `out`, which is a container like basic_headers
+    template <typename Headers>
+    void copy_trailers_to(Headers& out) const {
+        _trailers.copy_to(out);
+    }
+
+    const chunk_spans& next(std::size_t n) {
+        auto& inner = next_layer();
+        while (true) {
+            if (_decoder.state() == chunk_span_decoder::state_t::trailer_start && !_done) {
+                _try_read_trailer_section();
+            }
+            if (_done || _decoder.state() == chunk_span_decoder::state_t::trailer_start) {
+                // Nothing more to return, at least for now
+                _after = _decoder;
+                _spans = {};
+                return _spans;
+            }
+            // Ask for a bit more than `n`, to leave room for chunk heads
+            const_buffer in = inner.next(_with_head_room(n));
+            _after          = _decoder;
+            _spans          = _after.decode(in, n);
+            _in_begin       = in.data();
+            for (std::size_t i = 0; i < _spans.head_count; ++i) {
+                Stats::on_chunk_head();
+            }
+            if (_after.invalid()) {
+                throw std::runtime_error("neo::http chunk decoder found an invalid chunk head");
+            }
+            if (_spans.count != 0 || _spans.input_size == 0) {
+                return _spans;
+            }
+            // We only walked over chunk heads and delimiters. Move past them and look again.
+            _decoder = _after;
+            inner.consume(_spans.input_size);
+        }
+    }
+
+    void consume(std::size_t n) {
+        auto& inner = next_layer();
+        for (std::size_t idx = 0; idx < _spans.count; ++idx) {
+            auto span = _spans.buffers[idx];
+            if (n < span.size()) {
+                // Stop inside this span. We'll walk the chunk heads after it again on next().
+                _decoder.resume_data(_spans.chunk_remaining[idx] - n);
+                inner.consume(static_cast<std::size_t>(span.data() + n - _in_begin));
+                _spans.count = 0;
+                return;
+            }
+            n -= span.size();
+        }
+        neo_assert(expects,
+                   n == 0,
+                   "Cannot consume more bytes from a chunked_span_buffers than it returned",
+                   n);
+        _decoder = _after;
+        inner.consume(_spans.input_size);
+        _spans.count = 0;
+    }
+};
+
+template <buffer_source S>
+explicit chunked_span_buffers(S &&) -> chunked_span_buffers<S>;
+
+/**
+ * Create a decoder for the chunked body in `in`, picking chunked_span_buffers if `in` hands out
+ * contiguous buffers, and chunked_buffers otherwise. Either one validates the trailer section
+ * and has the same trailers() and copy_trailers_to(). The decoder reports to the statistics
+ * policy `Stats`.
+ */
+template <typename Stats = no_parse_stats, buffer_source In>
+auto make_chunked_source(In&& in) {
+    if constexpr (std::is_convertible_v<decltype(in.next(1)), const_buffer>) {
+        return chunked_span_buffers<In, 1024, Stats>{NEO_FWD(in)};
+    } else {
+        return chunked_buffers<In, 256, 1024, Stats>{NEO_FWD(in)};
+    }
+}
+
 }  // namespace neo::http
@@ -1,5 +1,7 @@
 #include <neo/http/parse/chunked.hpp>
 
+#include <neo/http/headers.hpp>
+
 #include <neo/iostream_io.hpp>
 #include <neo/pathological_buffer_range.hpp>
 #include <neo/string_io.hpp>
@@ -7,10 +9,17 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 NEO_TEST_CONCEPT(neo::buffer_source<neo::http::chunked_buffers<neo::proto_buffer_source>>);
+NEO_TEST_CONCEPT(neo::buffer_source<neo::http::chunked_span_buffers<neo::proto_buffer_source>>);
 
 namespace fs = std::filesystem;
 
@@ -21,6 +30,7 @@ const auto DATA_DIR  = ROOT / "data";
 }  // namespace
 
 using namespace neo::literals;
+using namespace std::string_view_literals;
 
 TEST_CASE("Parse a basic chunk head") {
     auto buf = "4\r\nTest"_buf;
@@ -67,6 +77,332 @@ TEST_CASE("Pull from a buffer range, worst case") {
     CHECK(std::string_view(chunks.next(4)) == "");
 }
 
+TEST_CASE("Count the work done finding chunk heads") {
+    auto buf = neo::const_buffer(
+        "4\r\n"
+        "Text\r\n"
+        "0\r\n\r\n");
+    using stats   = neo::http::thread_parse_stats;
+    using inner_t = neo::buffers_consumer<neo::pathological_buffer_range>;
+
+    stats::current() = {};
+
+    neo::pathological_buffer_range                       rng{buf};
+    neo::http::chunked_buffers<inner_t, 256, 1024, stats> chunks{inner_t{rng}};
+    neo::string_dynbuf_io                                out;
+    CHECK(neo::buffer_copy(out, chunks) == 4);
+    CHECK(stats::current().chunk_heads == 2);
+    // Each chunk head is three bytes, seen one at a time
+    CHECK(stats::current().chunk_head_retries == 4);
+    CHECK(stats::current().chunk_bytes_copied == 3 + 2 + 3);
+
+    // A contiguous input is decoded in place
+    stats::current() = {};
+    auto span_chunks = neo::http::make_chunked_source<stats>(neo::buffers_consumer{buf});
+    CHECK(neo::buffer_copy(out, span_chunks) == 4);
+    CHECK(stats::current().chunk_heads == 2);
+    CHECK(stats::current().chunk_bytes_copied == 0);
+}
+
+TEST_CASE("Reject a chunk-size that is too large") {
+    CHECK(neo::http::chunk_head::parse("fffffffffffffffff\r\n"_buf).chunk_size == size_t(-1));
+    CHECK_FALSE(neo::http::chunk_head::parse("\r\n"_buf).valid());
+    // A bare CR in a chunk extension, which chunk_span_decoder rejects too
+    CHECK_FALSE(neo::http::chunk_head::parse("4;a\rb\r\n"_buf).valid());
+    CHECK(neo::http::chunk_head::parse("0000000000000000000aF\r\n"_buf).chunk_size == 0xaf);
+}
+
+TEST_CASE("Read trailer fields after the last chunk") {
+    auto buf = neo::const_buffer(
+        "4\r\n"
+        "Text\r\n"
+        "0\r\n"
+        "grpc-status: 0\r\n"
+        "Content-MD5: abcd\r\n"
+        "\r\n"
+        "Next");
+    neo::buffers_consumer      in{buf};
+    neo::http::chunked_buffers chunks{in};
+    neo::string_dynbuf_io      body;
+    neo::buffer_copy(body, chunks);
+    CHECK(body.read_area_view() == "Text");
+    REQUIRE(chunks.done());
+    // Exactly the bytes of the body were consumed
+    CHECK(std::string_view(neo::const_buffer(in.next(16))) == "Next");
+
+    std::vector<std::pair<std::string_view, std::string_view>> fields;
+    for (auto& field : chunks.trailers()) {
+        fields.emplace_back(field.key_view, field.value_view);
+    }
+    REQUIRE(fields.size() == 2);
+    CHECK(fields[0].first == "grpc-status");
+    CHECK(fields[0].second == "0");
+    CHECK(fields[1].first == "Content-MD5");
+    CHECK(fields[1].second == "abcd");
+
+    neo::http::headers headers;
+    chunks.copy_trailers_to(headers);
+    CHECK(headers.find("grpc-status"));
+    CHECK(headers.find(neo::http::header_id::content_md5)->value == "abcd");
+}
+
+TEST_CASE("Read trailer fields one byte at a time") {
+    auto buf = neo::const_buffer(
+        "1\r\n"
+        "T\r\n"
+        "0\r\n"
+        "Checksum: 1234\r\n"
+        "\r\n");
+    neo::pathological_buffer_range rng{buf};
+    neo::http::chunked_buffers     chunks{neo::buffers_consumer{rng}};
+    neo::string_dynbuf_io          body;
+    neo::buffer_copy(body, chunks);
+    CHECK(body.read_area_view() == "T");
+    REQUIRE(chunks.done());
+    CHECK(std::string_view(chunks.trailer_bytes()) == "Checksum: 1234\r\n");
+
+    // No trailer fields
+    neo::http::chunked_buffers plain{neo::buffers_consumer{neo::const_buffer("0\r\n\r\n")}};
+    neo::buffer_copy(body, plain);
+    CHECK(plain.done());
+    CHECK(plain.trailers().begin() == plain.trailers().end());
+}
+
+namespace {
+
+/// A contiguous buffer source that hands out one byte at a time
+struct one_byte_source {
+    neo::const_buffer buf;
+
+    neo::const_buffer next(std::size_t n) const noexcept {
+        return buf.first((std::min)({n, buf.size(), std::size_t(1)}));
+    }
+    void consume(std::size_t n) noexcept { buf += n; }
+};
+
+}  // namespace
+
+TEST_CASE("Read trailer fields with a chunked_span_buffers") {
+    auto buf = neo::const_buffer(
+        "4\r\n"
+        "Text\r\n"
+        "0\r\n"
+        "grpc-status: 0\r\n"
+        "Content-MD5: abcd\r\n"
+        "\r\n"
+        "Next");
+    neo::buffers_consumer in{buf};
+    auto                  chunks = neo::http::make_chunked_source(in);
+    static_assert(std::is_same_v<decltype(chunks), neo::http::chunked_span_buffers<decltype(in)&>>);
+    neo::string_dynbuf_io body;
+    neo::buffer_copy(body, chunks);
+    CHECK(body.read_area_view() == "Text");
+    REQUIRE(chunks.done());
+    // Exactly the bytes of the body were consumed
+    CHECK(std::string_view(neo::const_buffer(in.next(16))) == "Next");
+    CHECK(std::string_view(chunks.trailer_bytes()) == "grpc-status: 0\r\nContent-MD5: abcd\r\n");
+
+    neo::http::headers headers;
+    chunks.copy_trailers_to(headers);
+    CHECK(headers.find("grpc-status")->value == "0");
+    CHECK(headers.find(neo::http::header_id::content_md5)->value == "abcd");
+
+    // The same, split at every byte
+    neo::http::chunked_span_buffers trickle{one_byte_source{buf}};
+    neo::string_dynbuf_io           trickle_body;
+    neo::buffer_copy(trickle_body, trickle);
+    CHECK(trickle_body.read_area_view() == "Text");
+    REQUIRE(trickle.done());
+    CHECK(std::string_view(trickle.next_layer().buf) == "Next");
+    CHECK(std::string_view(trickle.trailer_bytes()) == std::string_view(chunks.trailer_bytes()));
+
+    // No trailer fields
+    neo::http::chunked_span_buffers plain{neo::buffers_consumer{neo::const_buffer("0\r\n\r\n")}};
+    neo::buffer_copy(body, plain);
+    CHECK(plain.done());
+    CHECK(plain.trailers().begin() == plain.trailers().end());
+}
+
+TEST_CASE("Reject bad trailer sections") {
+    auto bad = GENERATE(Catch::Generators::values<std::string>({
+        "0\r\nNot a field\r\n\r\n",
+        "0\r\nKey: " + std::string(2000, 'x') + "\r\n\r\n",
+    }));
+    neo::http::chunked_buffers chunks{neo::buffers_consumer{neo::const_buffer(bad)}};
+    neo::string_dynbuf_io      body;
+    CHECK_THROWS(neo::buffer_copy(body, chunks));
+
+    // A contiguous input is held to the same rules
+    neo::http::chunked_span_buffers spans{neo::buffers_consumer{neo::const_buffer(bad)}};
+    CHECK_THROWS(neo::buffer_copy(body, spans));
+}
+
+namespace {
+
+const auto many_chunks = std::string_view(
+    "4\r\n"
+    "Text\r\n"
+    "5;name=value\r\n"
+    "More!\r\n"
+    "A\r\n"
+    "0123456789\r\n"
+    "0\r\n"
+    "Trailer: value\r\n"
+    "\r\n");
+
+std::string decode_all(neo::http::chunk_span_decoder& dec, neo::const_buffer in) {
+    std::string ret;
+    while (!in.empty() && !dec.done() && !dec.invalid()) {
+        auto spans = dec.decode(in, 1024);
+        for (auto buf : spans) {
+            ret.append(std::string_view(buf));
+        }
+        in += spans.input_size;
+    }
+    return ret;
+}
+
+}  // namespace
+
+TEST_CASE("Decode several chunks at once") {
+    neo::http::chunk_span_decoder dec;
+    auto spans = dec.decode(neo::const_buffer(many_chunks), 1024);
+    CHECK(dec.done());
+    CHECK(spans.input_size == many_chunks.size());
+    REQUIRE(spans.count == 3);
+    CHECK(std::string_view(spans.buffers[0]) == "Text");
+    CHECK(std::string_view(spans.buffers[1]) == "More!");
+    CHECK(std::string_view(spans.buffers[2]) == "0123456789");
+    CHECK(spans.byte_size() == 19);
+}
+
+TEST_CASE("Decode chunks split at every byte") {
+    neo::http::chunk_span_decoder dec;
+    std::string                   data;
+    for (std::size_t idx = 0; idx < many_chunks.size(); ++idx) {
+        CHECK_FALSE(dec.done());
+        data += decode_all(dec, neo::const_buffer(many_chunks.substr(idx, 1)));
+    }
+    CHECK(dec.done());
+    CHECK(data == "TextMore!0123456789");
+}
+
+TEST_CASE("Limit the data decoded at once") {
+    neo::http::chunk_span_decoder dec;
+    auto spans = dec.decode(neo::const_buffer(many_chunks), 6);
+    REQUIRE(spans.count == 2);
+    CHECK(std::string_view(spans.buffers[1]) == "Mo");
+    CHECK(spans.chunk_remaining[1] == 5);
+    CHECK_FALSE(dec.done());
+    spans = dec.decode(neo::const_buffer(many_chunks) + spans.input_size, 1024);
+    REQUIRE(spans.count == 2);
+    CHECK(std::string_view(spans.buffers[0]) == "re!");
+    CHECK(dec.done());
+}
+
+TEST_CASE("Reject invalid chunked data") {
+    auto bad = GENERATE(Catch::Generators::values<std::string_view>({
+        "x\r\n",
+        "\r\n",
+        "4\r\nTextXX",
+        "4\rXText\r\n",
+        "11111111111111111\r\n",
+        "0\r\n\rX",
+    }));
+    INFO(bad);
+    neo::http::chunk_span_decoder dec;
+    decode_all(dec, neo::const_buffer(bad));
+    CHECK(dec.invalid());
+}
+
+TEST_CASE("Pull many chunks at once from a chunked_span_buffers") {
+    auto                            buf = neo::const_buffer(many_chunks);
+    neo::http::chunked_span_buffers chunks{neo::buffers_consumer{buf}};
+    auto&&                          spans = chunks.next(1024);
+    CHECK(neo::buffer_size(spans) == 19);
+    // Stop in the middle of the second chunk
+    chunks.consume(6);
+    CHECK(std::string_view(*chunks.next(1024).begin()) == "re!");
+    chunks.consume(3);
+    CHECK(std::string_view(*chunks.next(1024).begin()) == "0123456789");
+    chunks.consume(10);
+    CHECK(neo::buffer_size(chunks.next(1024)) == 0);
+    CHECK(chunks.done());
+}
+
+TEST_CASE("Ask a chunked_span_buffers for a huge amount") {
+    auto                            buf = neo::const_buffer(many_chunks);
+    neo::http::chunked_span_buffers chunks{neo::buffers_consumer{buf}};
+    // Adding head room to this would wrap around to a request for just three bytes
+    auto n = (std::numeric_limits<std::size_t>::max() - 60) / 5 * 4;
+    CHECK(neo::buffer_size(chunks.next(n)) == 19);
+    CHECK(neo::buffer_size(chunks.next(std::numeric_limits<std::size_t>::max())) == 19);
+}
+
+TEST_CASE("Copy from a chunked_span_buffers") {
+    std::string encoded;
+    std::string expect;
+    for (int n = 0; n < 500; ++n) {
+        auto chunk = std::string(static_cast<std::size_t>(100 + n % 50), char('a' + n % 26));
+        char size_buf[16];
+        auto size_end = std::to_chars(size_buf, size_buf + 16, chunk.size(), 16).ptr;
+        encoded.append(size_buf, size_end).append("\r\n").append(chunk).append("\r\n");
+        expect.append(chunk);
+    }
+    encoded.append("0\r\n\r\n");
+
+    neo::http::chunked_span_buffers chunks{neo::buffers_consumer{neo::const_buffer(encoded)}};
+    neo::string_dynbuf_io           out;
+    neo::buffer_copy(out, chunks);
+    CHECK(chunks.done());
+    CHECK(out.read_area_view() == expect);
+}
+
+TEST_CASE("Decode a chunked body in place") {
+    using status_t = neo::http::dechunked_buffer::status_t;
+
+    std::string buf = std::string(many_chunks) + "GET / HTTP/1.1\r\n";
+    auto        res = neo::http::dechunk_in_place(neo::mutable_buffer(buf));
+    CHECK(res.status == status_t::done);
+    CHECK(res.body.data() == neo::mutable_buffer(buf).data());
+    CHECK(std::string_view(res.body) == "TextMore!0123456789");
+    CHECK(std::string_view(res.tail) == "GET / HTTP/1.1\r\n");
+
+    buf = "3\r\nabc\r\n0\r\n\r\n";
+    res = neo::http::dechunk_in_place(neo::mutable_buffer(buf));
+    CHECK(res.status == status_t::done);
+    CHECK(std::string_view(res.body) == "abc");
+    CHECK(res.tail.empty());
+}
+
+TEST_CASE("Decode an incomplete chunked body in place") {
+    using status_t = neo::http::dechunked_buffer::status_t;
+
+    auto full = std::string(many_chunks);
+    for (auto len : {0, 1, 3, 8, 12, 20, 40, 46}) {
+        INFO(len);
+        std::string buf = full.substr(0, static_cast<std::size_t>(len));
+        auto        res = neo::http::dechunk_in_place(neo::mutable_buffer(buf));
+        CHECK(res.status == status_t::incomplete);
+        // The tail is the undecoded remainder of the input
+        CHECK(res.tail.data_end() == neo::mutable_buffer(buf).data_end());
+        CHECK("TextMore!0123456789"sv.starts_with(std::string_view(res.body)));
+    }
+}
+
+TEST_CASE("Reject an invalid chunked body in place") {
+    using status_t = neo::http::dechunked_buffer::status_t;
+
+    auto bad = GENERATE(Catch::Generators::values<std::string>({
+        "x\r\n",
+        "4\r\nTextXX",
+        "4\r\nText\r\n\r\n",
+    }));
+    INFO(bad);
+    auto res = neo::http::dechunk_in_place(neo::mutable_buffer(bad));
+    CHECK(res.status == status_t::invalid);
+}
+
 TEST_CASE("Read all of Shakespeare") {
     std::ifstream         infile{DATA_DIR / "shakespeare.chunked.txt", std::ios::binary};
     neo::iostream_io      file_in{infile};
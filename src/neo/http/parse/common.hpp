@@ -1,7 +1,11 @@
 #pragma once
 
+#include "./scan.hpp"
+
 #include <neo/const_buffer.hpp>
 
+#include <type_traits>
+
 namespace neo::http {
 
 constexpr bool is_crlf(const_buffer buf) {
@@ -12,13 +16,20 @@ constexpr bool begins_with_crlf(const_buffer buf) {
     return buf.size() >= 2 && is_crlf(buf.first(2));
 }
 
+/// Find the offset of the first CRLF in the buffer, or -1 if there is none
 constexpr std::ptrdiff_t find_crlf(const const_buffer buf) {
-    for (auto b2 = buf; b2; b2 += 1) {
-        if (begins_with_crlf(b2)) {
-            return b2.data() - buf.data();
-        }
-    }
-    return -1;
+    auto found = std::is_constant_evaluated()
+        ? parse_detail::scan_crlf_scalar(buf.data(), buf.data_end())
+        : parse_detail::scan_crlf(buf.data(), buf.data_end());
+    return found == buf.data_end() ? -1 : found - buf.data();
+}
+
+/// Find the offset of the first CRLFCRLF (the end of a message head), or -1 if there is none
+constexpr std::ptrdiff_t find_crlfcrlf(const const_buffer buf) {
+    auto found = std::is_constant_evaluated()
+        ? parse_detail::scan_crlfcrlf_scalar(buf.data(), buf.data_end())
+        : parse_detail::scan_crlfcrlf(buf.data(), buf.data_end());
+    return found == buf.data_end() ? -1 : found - buf.data();
 }
 
-}  // namespace neo::http
\ No newline at end of file
+}  // namespace neo::http
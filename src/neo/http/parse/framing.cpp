@@ -0,0 +1,92 @@
+#include "./framing.hpp"
+
+#include <neo/http/headers.hpp>
+
+#include <charconv>
+
+namespace {
+
+constexpr bool is_ows(char c) noexcept { return c == ' ' || c == '\t'; }
+
+/// Call `fn` with each element of a comma-separated list, with surrounding whitespace removed
+template <typename Fn>
+void for_each_list_element(std::string_view list, Fn&& fn) {
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        auto elem  = list.substr(0, comma);
+        list       = comma == list.npos ? std::string_view() : list.substr(comma + 1);
+        while (!elem.empty() && is_ows(elem.front())) {
+            elem.remove_prefix(1);
+        }
+        while (!elem.empty() && is_ows(elem.back())) {
+            elem.remove_suffix(1);
+        }
+        if (!elem.empty()) {
+            fn(elem);
+        }
+    }
+}
+
+using neo::http::header_key_equivalent;
+
+}  // namespace
+
+void neo::http::message_framing::add_field(const header_bufs& field) noexcept {
+    switch (field.id) {
+    case header_id::content_length:
+        // A list of identical values is allowed (RFC 7230 section 3.3.2)
+        for_each_list_element(field.value_view, [&](std::string_view elem) {
+            std::uint64_t value = 0;
+            auto [ptr, ec]      = std::from_chars(elem.data(), elem.data() + elem.size(), value);
+            if (ec != std::errc() || ptr != elem.data() + elem.size()
+                || (has_content_length && value != content_length)) {
+                invalid = true;
+            }
+            has_content_length = true;
+            content_length     = value;
+        });
+        if (field.value_view.find_first_not_of(" \t,") == field.value_view.npos) {
+            // An empty value
+            invalid = true;
+        }
+        break;
+    case header_id::transfer_encoding:
+        ++transfer_encoding_fields;
+        transfer_encoding = field.value_view;
+        chunked           = false;
+        for_each_list_element(field.value_view, [&](std::string_view coding) {
+            // Only the last coding counts
+            chunked = header_key_equivalent(coding, "chunked");
+        });
+        break;
+    case header_id::connection:
+        for_each_list_element(field.value_view, [&](std::string_view opt) {
+            if (header_key_equivalent(opt, "close")) {
+                close = true;
+            } else if (header_key_equivalent(opt, "keep-alive")) {
+                keep_alive = true;
+            } else if (header_key_equivalent(opt, "upgrade")) {
+                connection_upgrade = true;
+            }
+        });
+        break;
+    case header_id::upgrade:
+        upgrade = field.value_view;
+        break;
+    case header_id::expect:
+        if (header_key_equivalent(field.value_view, "100-continue")) {
+            expect_continue = true;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void neo::http::message_framing::finish(http::version ver) noexcept {
+    if (has_content_length && has_transfer_encoding()) {
+        invalid = true;
+    }
+    // HTTP/1.1 connections persist by default. HTTP/1.0 connections only persist on request.
+    keep_alive = !close && (ver == version::v1_1 || keep_alive);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "./header.hpp"
+#include <neo/http/version.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace neo::http {
+
+/**
+ * A summary of the header fields that determine how a message is delimited and how the
+ * connection behaves, collected while the header fields are parsed (RFC 7230 sections 3.3 and
+ * 6.1, and RFC 7231 section 5.1.1).
+ *
+ * Everything is a plain value, except `transfer_encoding` and `upgrade`, which are views of
+ * field values in the message head's buffer.
+ */
+struct message_framing {
+    /// Whether there is a valid Content-Length field
+    bool has_content_length = false;
+    /// The value of the Content-Length field
+    std::uint64_t content_length = 0;
+
+    /**
+     * The number of Transfer-Encoding fields. This must not wrap around for any head, or a head
+     * with both Content-Length and Transfer-Encoding could pass as having only a Content-Length.
+     */
+    std::size_t transfer_encoding_fields = 0;
+    /// The value of the last Transfer-Encoding field. Refers to the head buffer.
+    std::string_view transfer_encoding;
+    /// Whether the final transfer-coding is "chunked"
+    bool chunked = false;
+
+    /// Whether the connection persists after this message (per the version and Connection)
+    bool keep_alive = false;
+    /// Whether the Connection field includes "close"
+    bool close = false;
+    /// Whether the Connection field includes "upgrade"
+    bool connection_upgrade = false;
+    /// The value of the Upgrade field, if any. Refers to the head buffer.
+    std::string_view upgrade;
+
+    /// Whether the message has "Expect: 100-continue"
+    bool expect_continue = false;
+
+    /**
+     * Whether the framing is unusable: a malformed or overflowing Content-Length, several
+     * Content-Lengths that disagree, or both Content-Length and Transfer-Encoding (a request
+     * smuggling risk, RFC 7230 section 3.3.3).
+     */
+    bool invalid = false;
+
+    constexpr bool has_transfer_encoding() const noexcept { return transfer_encoding_fields != 0; }
+
+    /// Update with one header field
+    void add_field(const header_bufs& field) noexcept;
+    /// Finish after the final header field has been added
+    void finish(http::version ver) noexcept;
+};
+
+}  // namespace neo::http
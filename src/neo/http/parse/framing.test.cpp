@@ -0,0 +1,181 @@
+#include <neo/http/parse/framing.hpp>
+
+#include <neo/http/parse/request.hpp>
+#include <neo/http/parse/response.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+using namespace neo;
+using namespace neo::http;
+
+using namespace std::string_view_literals;
+
+namespace {
+
+message_framing request_framing(std::string_view head) {
+    auto req = request_head::parse(const_buffer(head));
+    REQUIRE(req.valid());
+    return req.framing;
+}
+
+}  // namespace
+
+TEST_CASE("Collect Content-Length") {
+    auto framing = request_framing("POST / HTTP/1.1\r\nContent-Length: 1234\r\n\r\n");
+    CHECK_FALSE(framing.invalid);
+    CHECK(framing.has_content_length);
+    CHECK(framing.content_length == 1234);
+    CHECK_FALSE(framing.has_transfer_encoding());
+
+    // Repeated identical values are okay
+    framing = request_framing("POST / HTTP/1.1\r\nContent-Length: 12, 12\r\n\r\n");
+    CHECK_FALSE(framing.invalid);
+    CHECK(framing.content_length == 12);
+    framing = request_framing(
+        "POST / HTTP/1.1\r\nContent-Length: 12\r\ncontent-length: 12\r\n\r\n");
+    CHECK_FALSE(framing.invalid);
+    CHECK(framing.content_length == 12);
+
+    // A huge body is fine, as long as it fits
+    framing = request_framing("POST / HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\n");
+    CHECK_FALSE(framing.invalid);
+    CHECK(framing.content_length == 18446744073709551615ull);
+}
+
+TEST_CASE("Reject bad Content-Length") {
+    auto invalid = GENERATE(Catch::Generators::values<std::string_view>({
+        "POST / HTTP/1.1\r\nContent-Length: 12abc\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: -12\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: +12\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: \r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 18446744073709551616\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 12, 13\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 12\r\nContent-Length: 13\r\n\r\n",
+        // Both Content-Length and Transfer-Encoding
+        "POST / HTTP/1.1\r\nContent-Length: 12\r\nTransfer-Encoding: chunked\r\n\r\n",
+    }));
+    INFO(invalid);
+    CHECK(request_framing(invalid).invalid);
+}
+
+TEST_CASE("Collect Transfer-Encoding") {
+    auto framing = request_framing("POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n");
+    CHECK_FALSE(framing.invalid);
+    CHECK(framing.has_transfer_encoding());
+    CHECK(framing.transfer_encoding == "gzip, chunked");
+    CHECK(framing.chunked);
+
+    // Only the final coding matters
+    framing = request_framing("POST / HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\n\r\n");
+    CHECK(framing.has_transfer_encoding());
+    CHECK_FALSE(framing.chunked);
+
+    framing = request_framing(
+        "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\nTransfer-Encoding: Chunked\r\n\r\n");
+    CHECK(framing.transfer_encoding_fields == 2);
+    CHECK(framing.chunked);
+}
+
+TEST_CASE("Count any number of Transfer-Encoding fields") {
+    for (std::size_t n_fields : {255u, 256u, 257u, 511u, 512u, 1000u, 65536u}) {
+        CAPTURE(n_fields);
+        std::string fields;
+        for (std::size_t i = 0; i < n_fields; ++i) {
+            fields += "Transfer-Encoding: chunked\r\n";
+        }
+
+        auto framing = request_framing("POST / HTTP/1.1\r\n" + fields + "\r\n");
+        CHECK_FALSE(framing.invalid);
+        CHECK(framing.transfer_encoding_fields == n_fields);
+        CHECK(framing.has_transfer_encoding());
+        CHECK(framing.chunked);
+
+        // A Content-Length before or after the fields is a smuggling attempt
+        framing = request_framing("POST / HTTP/1.1\r\nContent-Length: 5\r\n" + fields + "\r\n");
+        CHECK(framing.invalid);
+        CHECK(framing.has_transfer_encoding());
+        framing = request_framing("POST / HTTP/1.1\r\n" + fields + "Content-Length: 5\r\n\r\n");
+        CHECK(framing.invalid);
+    }
+}
+
+TEST_CASE("Collect connection options") {
+    auto framing = request_framing("GET / HTTP/1.1\r\n\r\n");
+    CHECK(framing.keep_alive);
+    CHECK_FALSE(framing.close);
+
+    framing = request_framing("GET / HTTP/1.0\r\nHost: example.com\r\n\r\n");
+    CHECK_FALSE(framing.keep_alive);
+
+    framing = request_framing("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n");
+    CHECK(framing.keep_alive);
+
+    framing = request_framing("GET / HTTP/1.1\r\nConnection: foo, close\r\n\r\n");
+    CHECK_FALSE(framing.keep_alive);
+    CHECK(framing.close);
+
+    framing = request_framing(
+        "GET / HTTP/1.1\r\nConnection: upgrade\r\nUpgrade: websocket\r\n\r\n");
+    CHECK(framing.connection_upgrade);
+    CHECK(framing.upgrade == "websocket");
+
+    framing = request_framing("PUT / HTTP/1.1\r\nExpect: 100-continue\r\n\r\n");
+    CHECK(framing.expect_continue);
+}
+
+TEST_CASE("Collect framing from a response") {
+    auto resp = response_head::parse(
+        const_buffer("HTTP/1.1 200 OK\r\nContent-Length: 5\r\nConnection: close\r\n\r\n"sv));
+    REQUIRE(resp.valid());
+    CHECK(resp.framing.content_length == 5);
+    CHECK_FALSE(resp.framing.keep_alive);
+}
+
+TEST_CASE("Incremental parsing collects the same framing") {
+    auto head = "POST /foo HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Transfer-Encoding: gzip, chunked\r\n"
+                "Connection: close\r\n"
+                "\r\n"sv;
+    auto expect = request_framing(head);
+
+    auto check = [&](const request_head_parser& parser) {
+        REQUIRE(parser.done());
+        auto& actual = parser.head().framing;
+        CHECK(actual.transfer_encoding == expect.transfer_encoding);
+        CHECK(actual.chunked == expect.chunked);
+        CHECK(actual.close == expect.close);
+        CHECK(actual.keep_alive == expect.keep_alive);
+        CHECK(actual.invalid == expect.invalid);
+    };
+
+    SECTION("In a stable buffer") {
+        request_head_parser parser;
+        for (std::size_t n = 1; n <= head.size() && !parser.done(); ++n) {
+            parser.feed(const_buffer(head.substr(0, n)));
+        }
+        check(parser);
+    }
+
+    SECTION("In a buffer that moves") {
+        request_head_parser parser;
+        std::string         partial;
+        for (auto c : head) {
+            partial.push_back(c);
+            std::string copy = partial;
+            parser.feed(const_buffer(copy));
+            if (parser.done()) {
+                // The views must refer to the final buffer
+                auto& actual = parser.head().framing;
+                CHECK(actual.transfer_encoding.data() >= copy.data());
+                CHECK(actual.transfer_encoding == "gzip, chunked");
+                CHECK(actual.chunked);
+                CHECK_FALSE(actual.keep_alive);
+                break;
+            }
+        }
+        CHECK(parser.done());
+    }
+}
@@ -1,6 +1,7 @@
 #include "./header.hpp"
 
 #include "./abnf.hpp"
+#include "./scan.hpp"
 #include "./token.hpp"
 #include <neo/http/headers.hpp>
 
@@ -31,27 +32,29 @@ neo::http::header_bufs neo::http::header_bufs::parse_without_crlf(neo::const_buf
     // Skip the colon
     line += 1;
 
+    using namespace parse_detail;
+
     // Skip leading whitespace on the value
-    while (!line.empty() && parse_detail::WSP.contains(static_cast<char>(line[0]))) {
-        line += 1;
-    }
+    auto value_begin = skip_class(WSP, line.data(), line.data_end());
+    line += static_cast<std::size_t>(value_begin - line.data());
+
+    // The value is a run of field-content (VCHARs with interior whitespace). Find the end of the
+    // run, then remove the trailing whitespace from the value.
+    constexpr static auto field_chars       = VCHAR | WSP;
+    auto                  content_begin_buf = line;
+    auto                  content_stop = skip_class(field_chars, line.data(), line.data_end());
+    line += static_cast<std::size_t>(content_stop - line.data());
 
-    // Create a buffer from the value, removing trailing whitespace
-    auto             content_begin_buf = line;
-    const std::byte* content_end       = line.data();
-    while (!line.empty() && parse_detail::VCHAR.contains(static_cast<char>(line[0]))) {
-        // Consume a field-content part
-        line += 1;
-        content_end = line.data();
-        // Skip all whitespace
-        while (!line.empty() && parse_detail::WSP.contains(static_cast<char>(line[0]))) {
-            line += 1;
-        }
+    auto content_end = content_stop;
+    while (content_end != content_begin_buf.data()
+           && WSP.contains(static_cast<char>(content_end[-1]))) {
+        --content_end;
     }
 
     auto field_buf = content_begin_buf.first(content_end - content_begin_buf.data());
 
-    return {std::string_view(name_tok.view), std::string_view(field_buf), line};
+    auto key = std::string_view(name_tok.view);
+    return {key, std::string_view(field_buf), line, classify_header(key)};
 }
 
 bool neo::http::header_bufs::key_equivalent(neo::const_buffer buf) const noexcept {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <neo/http/parse/common.hpp>
+#include <neo/http/parse/header_id.hpp>
 
 #include <neo/ad_hoc_range.hpp>
 #include <neo/const_buffer.hpp>
@@ -16,81 +17,6 @@
 
 namespace neo::http {
 
-namespace standard_headers {
-constexpr std::string_view a_im                             = "A-IM";
-constexpr std::string_view accept                           = "Accept";
-constexpr std::string_view accept_charset                   = "Accept-Charset";
-constexpr std::string_view accept_datetime                  = "Accept-Datetime";
-constexpr std::string_view accept_encoding                  = "Accept-Encoding";
-constexpr std::string_view accept_language                  = "Accept-Language";
-constexpr std::string_view accept_patch                     = "Accept-Patch";
-constexpr std::string_view accept_ranges                    = "Accept-Ranges";
-constexpr std::string_view access_control_allow_credentials = "Access-Control-Allow-Credentials";
-constexpr std::string_view access_control_allow_headers     = "Access-Control-Allow-Headers";
-constexpr std::string_view access_control_allow_methods     = "Access-Control-Allow-Methods";
-constexpr std::string_view access_control_allow_origin      = "Access-Control-Allow-Origin";
-constexpr std::string_view access_control_expose_headers    = "Access-Control-Expose-Headers";
-constexpr std::string_view access_control_max_age           = "Access-Control-Max-Age";
-constexpr std::string_view access_control_request_headers   = "Access-Control-Request-Headers";
-constexpr std::string_view access_control_request_method    = "Access-Control-Request-Method";
-constexpr std::string_view age                              = "Age";
-constexpr std::string_view allow                            = "Allow";
-constexpr std::string_view alt_svc                          = "Alt-Svc";
-constexpr std::string_view authorization                    = "Authorization";
-constexpr std::string_view cache_control                    = "Cache-Control";
-constexpr std::string_view connection                       = "Connection";
-constexpr std::string_view content_disposition              = "Content-Disposition";
-constexpr std::string_view content_encoding                 = "Content-Encoding";
-constexpr std::string_view content_length                   = "Content-Length";
-constexpr std::string_view content_location                 = "Content-Location";
-constexpr std::string_view content_md5                      = "Content-MD5";
-constexpr std::string_view content_range                    = "Content-Range";
-constexpr std::string_view content_type                     = "Content-Type";
-constexpr std::string_view cookie                           = "Cookie";
-constexpr std::string_view date                             = "Date";
-constexpr std::string_view delta_base                       = "Delta-Base";
-constexpr std::string_view etag                             = "ETag";
-constexpr std::string_view expect                           = "Expect";
-constexpr std::string_view expires                          = "Expires";
-constexpr std::string_view forwarded                        = "Forwarded";
-constexpr std::string_view from                             = "From";
-constexpr std::string_view host                             = "Host";
-constexpr std::string_view http2_settings                   = "HTTP2-Settings";
-constexpr std::string_view if_match                         = "If-Match";
-constexpr std::string_view if_modified_since                = "If-Modified-Since";
-constexpr std::string_view if_none_match                    = "If-None-Match";
-constexpr std::string_view if_range                         = "If-Range";
-constexpr std::string_view if_unmodified_since              = "If-Unmodified-Since";
-constexpr std::string_view im                               = "IM";
-constexpr std::string_view last_modified                    = "Last-Modified";
-constexpr std::string_view link                             = "Link";
-constexpr std::string_view location                         = "Location";
-constexpr std::string_view max_forwards                     = "Max-Forwards";
-constexpr std::string_view origin                           = "Origin";
-constexpr std::string_view p3p                              = "P3P";
-constexpr std::string_view pragma                           = "Pragma";
-constexpr std::string_view proxy_authenticate               = "Proxy-Authenticate";
-constexpr std::string_view proxy_authorization              = "Proxy-Authorization";
-constexpr std::string_view public_key_pins                  = "Public-Key-Pins";
-constexpr std::string_view range                            = "Range";
-constexpr std::string_view referer                          = "Referer";
-constexpr std::string_view reply_after                      = "Reply-After";
-constexpr std::string_view server                           = "Server";
-constexpr std::string_view set_cookie                       = "Set-Cookie";
-constexpr std::string_view strict_transport_policy          = "Strict-Transport-Policy";
-constexpr std::string_view te                               = "TE";
-constexpr std::string_view tk                               = "Tk";
-constexpr std::string_view trailer                          = "Trailer";
-constexpr std::string_view transfer_encoding                = "Transfer-Encoding";
-constexpr std::string_view upgrade                          = "Upgrade";
-constexpr std::string_view user_agent                       = "User-Agent";
-constexpr std::string_view vary                             = "Vary";
-constexpr std::string_view via                              = "Via";
-constexpr std::string_view warning                          = "Warning";
-constexpr std::string_view www_authenticate                 = "WWW-Authenticate";
-constexpr std::string_view x_frame_options                  = "X-Frame-Options";
-}  // namespace standard_headers
-
 struct header_bufs {
     /// The buffer that wraps the header field key
     std::string_view key_view;
@@ -100,6 +26,9 @@ struct header_bufs {
     /// Trailing data from a parsed header
     neo::const_buffer parse_tail = {};
 
+    /// The standard header that the key names, if any. Set by parsing.
+    header_id id = header_id::unknown;
+
     static header_bufs parse_without_crlf(neo::const_buffer) noexcept;
     static header_bufs parse(neo::const_buffer cb) noexcept {
         auto h = parse_without_crlf(cb);
@@ -154,16 +83,13 @@ struct header_lines_buf {
     constexpr bool valid() const noexcept { return buffer.data() != nullptr; }
 
     constexpr static header_lines_buf parse(const_buffer in) noexcept {
-        std::string_view end           = "\r\n\r\n";
-        auto             headers_begin = in.data();
-        for (; in.size() >= end.size(); in += 1) {
-            if (in.first(4).equals_string(end)) {
-                auto headers_buf_size = (in.data() - headers_begin) + 2;
-                auto headers_buf      = const_buffer(headers_begin, headers_buf_size);
-                return {headers_buf, in + end.size()};
-            }
+        auto end_pos = find_crlfcrlf(in);
+        if (end_pos < 0) {
+            return {};
         }
-        return {};
+        // The headers buffer keeps the first CRLF of the CRLFCRLF, which ends the last header
+        auto headers_buf_size = static_cast<std::size_t>(end_pos) + 2;
+        return {in.first(headers_buf_size), in + (headers_buf_size + 2)};
     }
 
     constexpr auto iter_headers() const noexcept {
@@ -53,6 +53,7 @@ TEST_CASE("Cases") {
     CHECK(actual.key_equivalent(expect.key));
     CHECK(actual.value_view == expect.value);
     CHECK(actual.parse_tail.equals_string(expect.tail));
+    CHECK(actual.id == classify_header(expect.key));
 }
 
 TEST_CASE("Write headers") {
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace neo::http {
+
+/**
+ * The header fields that have a name in `standard_headers` and a `header_id`. Expands
+ * `X(identifier, "Field-Name")` once for each.
+ */
+#define NEO_HTTP_STANDARD_HEADERS(X) \
+    X(a_im,                             "A-IM") \
+    X(accept,                           "Accept") \
+    X(accept_charset,                   "Accept-Charset") \
+    X(accept_datetime,                  "Accept-Datetime") \
+    X(accept_encoding,                  "Accept-Encoding") \
+    X(accept_language,                  "Accept-Language") \
+    X(accept_patch,                     "Accept-Patch") \
+    X(accept_ranges,                    "Accept-Ranges") \
+    X(access_control_allow_credentials, "Access-Control-Allow-Credentials") \
+    X(access_control_allow_headers,     "Access-Control-Allow-Headers") \
+    X(access_control_allow_methods,     "Access-Control-Allow-Methods") \
+    X(access_control_allow_origin,      "Access-Control-Allow-Origin") \
+    X(access_control_expose_headers,    "Access-Control-Expose-Headers") \
+    X(access_control_max_age,           "Access-Control-Max-Age") \
+    X(access_control_request_headers,   "Access-Control-Request-Headers") \
+    X(access_control_request_method,    "Access-Control-Request-Method") \
+    X(age,                              "Age") \
+    X(allow,                            "Allow") \
+    X(alt_svc,                          "Alt-Svc") \
+    X(authorization,                    "Authorization") \
+    X(cache_control,                    "Cache-Control") \
+    X(connection,                       "Connection") \
+    X(content_disposition,              "Content-Disposition") \
+    X(content_encoding,                 "Content-Encoding") \
+    X(content_length,                   "Content-Length") \
+    X(content_location,                 "Content-Location") \
+    X(content_md5,                      "Content-MD5") \
+    X(content_range,                    "Content-Range") \
+    X(content_type,                     "Content-Type") \
+    X(cookie,                           "Cookie") \
+    X(date,                             "Date") \
+    X(delta_base,                       "Delta-Base") \
+    X(etag,                             "ETag") \
+    X(expect,                           "Expect") \
+    X(expires,                          "Expires") \
+    X(forwarded,                        "Forwarded") \
+    X(from,                             "From") \
+    X(host,                             "Host") \
+    X(http2_settings,                   "HTTP2-Settings") \
+    X(if_match,                         "If-Match") \
+    X(if_modified_since,                "If-Modified-Since") \
+    X(if_none_match,                    "If-None-Match") \
+    X(if_range,                         "If-Range") \
+    X(if_unmodified_since,              "If-Unmodified-Since") \
+    X(im,                               "IM") \
+    X(last_modified,                    "Last-Modified") \
+    X(link,                             "Link") \
+    X(location,                         "Location") \
+    X(max_forwards,                     "Max-Forwards") \
+    X(origin,                           "Origin") \
+    X(p3p,                              "P3P") \
+    X(pragma,                           "Pragma") \
+    X(proxy_authenticate,               "Proxy-Authenticate") \
+    X(proxy_authorization,              "Proxy-Authorization") \
+    X(public_key_pins,                  "Public-Key-Pins") \
+    X(range,                            "Range") \
+    X(referer,                          "Referer") \
+    X(reply_after,                      "Reply-After") \
+    X(server,                           "Server") \
+    X(set_cookie,                       "Set-Cookie") \
+    X(strict_transport_policy,          "Strict-Transport-Policy") \
+    X(te,                               "TE") \
+    X(tk,                               "Tk") \
+    X(trailer,                          "Trailer") \
+    X(transfer_encoding,                "Transfer-Encoding") \
+    X(upgrade,                          "Upgrade") \
+    X(user_agent,                       "User-Agent") \
+    X(vary,                             "Vary") \
+    X(via,                              "Via") \
+    X(warning,                          "Warning") \
+    X(www_authenticate,                 "WWW-Authenticate") \
+    X(x_frame_options,                  "X-Frame-Options")
+
+namespace standard_headers {
+#define X(Ident, Name) constexpr std::string_view Ident = Name;
+NEO_HTTP_STANDARD_HEADERS(X)
+#undef X
+}  // namespace standard_headers
+
+/**
+ * Identifies one of the standard header fields. Parsed header fields are tagged with their id so
+ * that well-known fields can be found without comparing strings.
+ */
+enum class header_id : std::uint8_t {
+    unknown = 0,
+#define X(Ident, Name) Ident,
+    NEO_HTTP_STANDARD_HEADERS(X)
+#undef X
+};
+
+namespace header_id_detail {
+
+inline constexpr std::string_view names[] = {
+    "",
+#define X(Ident, Name) Name,
+    NEO_HTTP_STANDARD_HEADERS(X)
+#undef X
+};
+
+inline constexpr std::size_t count = std::size(names);
+
+inline constexpr std::size_t max_name_size = [] {
+    std::size_t ret = 0;
+    for (auto n : names) {
+        ret = n.size() > ret ? n.size() : ret;
+    }
+    return ret;
+}();
+
+// There are many more slots than names, so a collision-free seed is quick to find
+inline constexpr std::size_t n_slots = 512;
+
+/// FNV-1a of the case-folded bytes. Folding with `| 0x20` is only exact for letters, but that's
+/// fine: a table hit is always confirmed with a real case-insensitive comparison.
+constexpr std::size_t slot_of(std::uint32_t seed, std::string_view key) noexcept {
+    std::uint32_t h = 2166136261u ^ seed;
+    for (char c : key) {
+        h ^= static_cast<std::uint8_t>(c) | 0x20u;
+        h *= 16777619u;
+    }
+    return (h ^ (h >> 15)) % n_slots;
+}
+
+/// Each slot holds the header_id whose name hashes to it, or `unknown`
+struct table {
+    std::uint32_t                  seed  = 0;
+    std::array<header_id, n_slots> slots = {};
+};
+
+inline constexpr table perfect_table = [] {
+    table ret;
+    for (;; ++ret.seed) {
+        ret.slots     = {};
+        bool collided = false;
+        for (std::size_t i = 1; i < count && !collided; ++i) {
+            auto& slot = ret.slots[slot_of(ret.seed, names[i])];
+            collided   = slot != header_id::unknown;
+            slot       = static_cast<header_id>(i);
+        }
+        if (!collided) {
+            return ret;
+        }
+    }
+}();
+
+constexpr bool is_alpha(unsigned char c) noexcept {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+}  // namespace header_id_detail
+
+/// The canonical spelling of a standard header field name. Empty for `header_id::unknown`.
+constexpr std::string_view header_name(header_id id) noexcept {
+    return header_id_detail::names[static_cast<std::size_t>(id)];
+}
+
+/// Classify a header field name. Names are compared case-insensitively.
+constexpr header_id classify_header(std::string_view key) noexcept {
+    using namespace header_id_detail;
+    if (key.size() > max_name_size) {
+        return header_id::unknown;
+    }
+    auto cand = perfect_table.slots[slot_of(perfect_table.seed, key)];
+    auto name = header_name(cand);
+    if (name.size() != key.size()) {
+        return header_id::unknown;
+    }
+    for (std::size_t i = 0; i < key.size(); ++i) {
+        auto a = static_cast<unsigned char>(key[i]);
+        auto b = static_cast<unsigned char>(name[i]);
+        if (a != b && !(is_alpha(b) && (a | 0x20u) == (b | 0x20u))) {
+            return header_id::unknown;
+        }
+    }
+    return cand;
+}
+
+}  // namespace neo::http
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "./common.hpp"
+#include "./framing.hpp"
 #include "./header.hpp"
 
+#include <neo/assert.hpp>
 #include <neo/const_buffer.hpp>
 
+#include <algorithm>
+
 namespace neo::http {
 
 template <typename Derived, typename StartLine>
@@ -13,6 +18,8 @@ struct message_head {
     start_line_type  start_line;
     header_lines_buf headers;
     const_buffer     parse_tail;
+    /// The framing of the message, collected from the header fields
+    message_framing framing;
 
     constexpr bool valid() const noexcept { return start_line.valid() && headers.valid(); }
 
@@ -21,9 +28,176 @@ struct message_head {
         if (!sl.valid()) {
             return {};
         }
+        if (begins_with_crlf(sl.parse_tail)) {
+            // There are no header fields: The start line is followed immediately by the empty line
+            auto            tail = sl.parse_tail + 2;
+            message_framing framing;
+            framing.finish(sl.http_version);
+            return {sl, header_lines_buf{sl.parse_tail.first(0), tail}, tail, framing};
+        }
         auto hl = header_lines_buf::parse(sl.parse_tail);
-        return {sl, hl, hl.parse_tail};
+        if (!hl.valid()) {
+            return {sl, hl, hl.parse_tail};
+        }
+        return {sl, hl, hl.parse_tail, scan_framing(hl, sl.http_version)};
+    }
+
+    /**
+     * Compute the framing of a message from its header fields. If a header line is malformed, the
+     * framing is invalid, since the fields after it would not be seen by iter_headers().
+     */
+    static message_framing scan_framing(const header_lines_buf& hl, http::version ver) noexcept {
+        message_framing framing;
+        auto            rest = hl.buffer;
+        for (auto& field : hl.iter_headers()) {
+            framing.add_field(field);
+            rest = field.parse_tail;
+        }
+        framing.finish(ver);
+        if (!rest.empty()) {
+            framing.invalid = true;
+        }
+        return framing;
+    }
+};
+
+/**
+ * Incrementally parse a message head as its bytes arrive.
+ *
+ * Each call to feed() is given *all* of the bytes of the head received so far (the buffer may be
+ * relocated between calls, but the prior bytes must be unchanged). The parser remembers where
+ * the start line and each complete header line end, so it only ever examines the new bytes.
+ * The result is the same as `Head::parse` on the complete head.
+ */
+template <typename Head>
+class head_parser {
+public:
+    using head_type       = Head;
+    using start_line_type = typename Head::start_line_type;
+
+    enum class status_t {
+        incomplete,
+        done,
+        invalid,
+    };
+
+private:
+    status_t _status = status_t::incomplete;
+
+    // Offset just past the CRLF of the start line, or zero if we haven't seen it yet
+    std::size_t _start_line_end = 0;
+    // Offset of the beginning of the line we are waiting to see the end of
+    std::size_t _line_begin = 0;
+    // Offset at which to resume looking for the next CRLF
+    std::size_t _search_pos = 0;
+    // Offset just past the empty line that ends the head
+    std::size_t _head_end = 0;
+
+    std::size_t _n_headers = 0;
+
+    // The buffer that we parsed `_head.start_line` from, to know if its views are still good.
+    const std::byte* _start_line_src = nullptr;
+    // The buffer that the views in `_head.framing` refer to
+    const std::byte* _framing_src = nullptr;
+    // Whether header fields were added to `_head.framing` from more than one buffer
+    bool _framing_stale = false;
+
+    head_type _head;
+
+    status_t _finish(const_buffer buf) noexcept {
+        _head_end = _search_pos;
+        if (buf.data() != _start_line_src) {
+            // The buffer moved since we checked the start line. Get new views of it.
+            _head.start_line = start_line_type::parse(buf);
+        }
+        auto headers_begin          = buf + _start_line_end;
+        _head.start_line.parse_tail = headers_begin;
+        _head.headers.buffer        = headers_begin.first(_line_begin - _start_line_end);
+        _head.headers.parse_tail    = buf + _head_end;
+        _head.parse_tail            = buf + _head_end;
+        if (_framing_stale || (_framing_src != nullptr && buf.data() != _framing_src)) {
+            // Some header fields were seen in a buffer that has since moved. This is rare, so
+            // just walk the fields again rather than tracking the views as offsets.
+            _head.framing = head_type::scan_framing(_head.headers, _head.start_line.http_version);
+        } else {
+            _head.framing.finish(_head.start_line.http_version);
+        }
+        return _status = status_t::done;
+    }
+
+public:
+    constexpr status_t status() const noexcept { return _status; }
+    constexpr bool     done() const noexcept { return _status == status_t::done; }
+    constexpr bool     invalid() const noexcept { return _status == status_t::invalid; }
+
+    /// The parsed head. Only meaningful once done(), and refers to the buffer last given to feed()
+    constexpr const head_type& head() const noexcept { return _head; }
+
+    /// The number of bytes in the head, including the final empty line. Only meaningful once done()
+    constexpr std::size_t head_size() const noexcept { return _head_end; }
+
+    /// The number of complete header lines seen so far
+    constexpr std::size_t header_count() const noexcept { return _n_headers; }
+
+    void reset() noexcept { *this = head_parser(); }
+
+    /**
+     * Continue parsing. `buf` must hold every byte of the head that has been received so far,
+     * beginning with the first byte of the start line.
+     */
+    status_t feed(const_buffer buf) noexcept {
+        if (_status != status_t::incomplete) {
+            return _status;
+        }
+        neo_assert(expects,
+                   buf.size() >= _search_pos,
+                   "head_parser::feed() was given fewer bytes than it was given previously",
+                   buf.size(),
+                   _search_pos);
+
+        while (true) {
+            auto crlf_pos = find_crlf(buf + _search_pos);
+            if (crlf_pos < 0) {
+                // Back up one byte in case the next bytes complete a CRLF
+                _search_pos = (std::max)(_line_begin, buf.size() == 0 ? 0 : buf.size() - 1);
+                return _status;
+            }
+            auto line_end = _search_pos + static_cast<std::size_t>(crlf_pos) + 2;
+            _search_pos   = line_end;
+
+            if (_start_line_end == 0) {
+                auto sl = start_line_type::parse(buf.first(line_end));
+                if (!sl.valid() || !sl.parse_tail.empty()) {
+                    return _status = status_t::invalid;
+                }
+                _head.start_line = sl;
+                _start_line_src  = buf.data();
+                _start_line_end = _line_begin = line_end;
+                continue;
+            }
+
+            if (line_end - _line_begin == 2) {
+                // An empty line: This is the end of the head
+                return _finish(buf);
+            }
+
+            auto header = header_bufs::parse(buf.first(line_end) + _line_begin);
+            if (!header.valid() || !header.parse_tail.empty()) {
+                // A malformed header line. We reject the head rather than skip the line, since
+                // iter_headers() would stop at it and miss the fields that follow.
+                return _status = status_t::invalid;
+            } else if (_framing_src != nullptr && _framing_src != buf.data()) {
+                // The buffer moved. _finish() will collect the framing again.
+                _framing_stale = true;
+            } else {
+                // Collect the framing in the same pass
+                _head.framing.add_field(header);
+                _framing_src = buf.data();
+            }
+            ++_n_headers;
+            _line_begin = line_end;
+        }
     }
 };
 
-}  // namespace neo::http
\ No newline at end of file
+}  // namespace neo::http
@@ -0,0 +1,118 @@
+#include "./pipeline.hpp"
+
+#include "./common.hpp"
+#include "./header.hpp"
+#include "./request.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void neo::http::request_batch::clear() noexcept {
+    buffer     = {};
+    parse_tail = {};
+    stop       = stop_reason::end_of_buffer;
+    head_offsets.clear();
+    head_sizes.clear();
+    method_sizes.clear();
+    target_offsets.clear();
+    target_sizes.clear();
+    versions.clear();
+    header_ends.clear();
+    key_offsets.clear();
+    key_sizes.clear();
+    value_offsets.clear();
+    value_sizes.clear();
+    header_ids.clear();
+}
+
+namespace {
+
+// Append one head to the batch. Returns `false` (leaving the batch unchanged) if it is not valid.
+bool append_head(neo::http::request_batch& batch, neo::const_buffer head, bool& has_body) {
+    using namespace neo::http;
+    auto offset_of = [&](const void* ptr) {
+        return static_cast<std::uint32_t>(static_cast<const std::byte*>(ptr)
+                                          - batch.buffer.data());
+    };
+
+    auto sl = request_line::parse(head);
+    if (!sl.valid() || sl.method_view.size() > (std::numeric_limits<std::uint16_t>::max)()) {
+        return false;
+    }
+
+    auto n_fields = batch.key_offsets.size();
+    auto rollback = [&] {
+        batch.key_offsets.resize(n_fields);
+        batch.key_sizes.resize(n_fields);
+        batch.value_offsets.resize(n_fields);
+        batch.value_sizes.resize(n_fields);
+        batch.header_ids.resize(n_fields);
+        return false;
+    };
+
+    has_body  = false;
+    auto line = sl.parse_tail;
+    while (!is_crlf(line)) {
+        auto field = header_bufs::parse(line);
+        if (!field.valid()
+            || field.key_view.size() > (std::numeric_limits<std::uint16_t>::max)()) {
+            return rollback();
+        }
+        batch.key_offsets.push_back(offset_of(field.key_view.data()));
+        batch.key_sizes.push_back(static_cast<std::uint16_t>(field.key_view.size()));
+        batch.value_offsets.push_back(offset_of(field.value_view.data()));
+        batch.value_sizes.push_back(static_cast<std::uint32_t>(field.value_view.size()));
+        batch.header_ids.push_back(field.id);
+        if ((field.id == header_id::content_length && field.value_view != "0")
+            || field.id == header_id::transfer_encoding) {
+            has_body = true;
+        }
+        line = field.parse_tail;
+    }
+
+    // The target is the path, plus the query if there is one
+    auto& target      = sl.target;
+    auto  target_size = target.has_query
+        ? static_cast<std::size_t>(target.query_view.data() + target.query_view.size()
+                                   - target.path_view.data())
+        : target.path_view.size();
+
+    batch.head_offsets.push_back(offset_of(head.data()));
+    batch.head_sizes.push_back(static_cast<std::uint32_t>(head.size()));
+    batch.method_sizes.push_back(static_cast<std::uint16_t>(sl.method_view.size()));
+    batch.target_offsets.push_back(offset_of(target.path_view.data()));
+    batch.target_sizes.push_back(static_cast<std::uint32_t>(target_size));
+    batch.versions.push_back(sl.http_version);
+    batch.header_ends.push_back(static_cast<std::uint32_t>(batch.key_offsets.size()));
+    return true;
+}
+
+}  // namespace
+
+void neo::http::parse_request_batch(const_buffer buf, request_batch& batch) {
+    batch.clear();
+    constexpr std::size_t max_size = (std::numeric_limits<std::uint32_t>::max)();
+    batch.buffer = buf.first((std::min)(buf.size(), max_size));
+
+    auto rest = batch.buffer;
+    while (true) {
+        auto end_pos = find_crlfcrlf(rest);
+        if (end_pos < 0) {
+            batch.stop = request_batch::stop_reason::end_of_buffer;
+            break;
+        }
+        // The head includes the empty line that ends it
+        auto head     = rest.first(static_cast<std::size_t>(end_pos) + 4);
+        bool has_body = false;
+        if (!append_head(batch, head, has_body)) {
+            batch.stop = request_batch::stop_reason::invalid;
+            break;
+        }
+        rest += head.size();
+        if (has_body) {
+            batch.stop = request_batch::stop_reason::body;
+            break;
+        }
+    }
+    batch.parse_tail = rest;
+}
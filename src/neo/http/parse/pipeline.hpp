@@ -0,0 +1,119 @@
+#pragma once
+
+#include "./header_id.hpp"
+#include <neo/http/version.hpp>
+
+#include <neo/const_buffer.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace neo::http {
+
+/**
+ * Every complete request head found in a buffer by parse_request_batch(), stored column-wise.
+ *
+ * Rather than views, each request and header field records 32-bit offsets into `buffer` and
+ * 16- or 32-bit sizes. Column `i` of the request columns describes the i'th request. The header
+ * columns hold the header fields of all requests back-to-back. Request `i` owns the fields in
+ * `header_indices(i)`.
+ *
+ * A batch may be reused: parsing into it again keeps the capacity of its columns.
+ */
+struct request_batch {
+    enum class stop_reason {
+        /// Parsed everything up to the end of the buffer. `parse_tail` holds a partial head, if any
+        end_of_buffer,
+        /// The last request has a body, which begins at `parse_tail`
+        body,
+        /// The head at `parse_tail` is malformed, or uses a construct the batch parser does not
+        /// accept. Handle it with request_head::parse.
+        invalid,
+    };
+
+    /// The parsed buffer. Offsets are relative to its beginning.
+    const_buffer buffer;
+    /// The bytes following the last complete head
+    const_buffer parse_tail;
+    stop_reason  stop = stop_reason::end_of_buffer;
+
+    // Request columns
+    std::vector<std::uint32_t> head_offsets;
+    std::vector<std::uint32_t> head_sizes;
+    std::vector<std::uint16_t> method_sizes;  // The method begins at the head offset
+    std::vector<std::uint32_t> target_offsets;
+    std::vector<std::uint32_t> target_sizes;
+    std::vector<http::version> versions;
+    std::vector<std::uint32_t> header_ends;
+
+    // Header field columns
+    std::vector<std::uint32_t> key_offsets;
+    std::vector<std::uint16_t> key_sizes;
+    std::vector<std::uint32_t> value_offsets;
+    std::vector<std::uint32_t> value_sizes;
+    std::vector<header_id>     header_ids;
+
+    /// The number of complete request heads
+    std::size_t size() const noexcept { return head_offsets.size(); }
+
+    std::string_view method(std::size_t req) const noexcept {
+        return _view(head_offsets[req], method_sizes[req]);
+    }
+    std::string_view target(std::size_t req) const noexcept {
+        return _view(target_offsets[req], target_sizes[req]);
+    }
+    const_buffer head(std::size_t req) const noexcept {
+        return (buffer + head_offsets[req]).first(head_sizes[req]);
+    }
+
+    /// The range of header field indices [first, last) that belong to the given request
+    std::pair<std::size_t, std::size_t> header_indices(std::size_t req) const noexcept {
+        return {req == 0 ? 0 : header_ends[req - 1], header_ends[req]};
+    }
+
+    std::string_view header_key(std::size_t field) const noexcept {
+        return _view(key_offsets[field], key_sizes[field]);
+    }
+    std::string_view header_value(std::size_t field) const noexcept {
+        return _view(value_offsets[field], value_sizes[field]);
+    }
+
+    /// Find the first field in the given request with the given id. Returns -1 if there is none.
+    std::ptrdiff_t find_header(std::size_t req, header_id id) const noexcept {
+        auto [first, last] = header_indices(req);
+        for (auto field = first; field != last; ++field) {
+            if (header_ids[field] == id) {
+                return static_cast<std::ptrdiff_t>(field);
+            }
+        }
+        return -1;
+    }
+
+    void clear() noexcept;
+
+private:
+    std::string_view _view(std::uint32_t offset, std::size_t size) const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(buffer.data()) + offset, size);
+    }
+};
+
+/**
+ * Parse as many complete request heads from `buf` as possible, for pipelined requests.
+ *
+ * Parsing stops at the end of the buffer, after the first request that has a message body
+ * (which would otherwise be mistaken for the next head), or at a head that fails to parse.
+ * See request_batch::stop_reason. The previous contents of `out` are discarded.
+ *
+ * Only the first 4GB of `buf` are examined.
+ */
+void parse_request_batch(const_buffer buf, request_batch& out);
+
+inline request_batch parse_request_batch(const_buffer buf) {
+    request_batch ret;
+    parse_request_batch(buf, ret);
+    return ret;
+}
+
+}  // namespace neo::http
@@ -0,0 +1,94 @@
+#include <neo/http/parse/pipeline.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace neo::http;
+using stop_reason = request_batch::stop_reason;
+
+TEST_CASE("Parse a batch of pipelined requests") {
+    auto buf = neo::const_buffer(
+        "GET /index.html HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Accept: */*\r\n"
+        "\r\n"
+        "GET /style.css?v=2 HTTP/1.1\r\n"
+        "\r\n"
+        "HEAD /favicon.ico HTTP/1.0\r\n"
+        "X-Custom: yes\r\n"
+        "\r\n"
+        "GET /partial HTTP/1.1\r\n"
+        "Host: exa");
+
+    auto batch = parse_request_batch(buf);
+    REQUIRE(batch.size() == 3);
+    CHECK(batch.stop == stop_reason::end_of_buffer);
+    CHECK(std::string_view(batch.parse_tail) == "GET /partial HTTP/1.1\r\nHost: exa");
+
+    CHECK(batch.method(0) == "GET");
+    CHECK(batch.target(0) == "/index.html");
+    CHECK(batch.versions[0] == version::v1_1);
+    auto [first, last] = batch.header_indices(0);
+    CHECK(last - first == 2);
+    CHECK(batch.header_key(first) == "Host");
+    CHECK(batch.header_value(first) == "example.com");
+    CHECK(batch.header_ids[first + 1] == header_id::accept);
+    CHECK(batch.find_header(0, header_id::host) == static_cast<std::ptrdiff_t>(first));
+
+    CHECK(batch.target(1) == "/style.css?v=2");
+    CHECK(batch.header_indices(1).first == batch.header_indices(1).second);
+    CHECK(batch.find_header(1, header_id::host) == -1);
+
+    CHECK(batch.method(2) == "HEAD");
+    CHECK(batch.versions[2] == version::v1_0);
+    auto custom = batch.header_indices(2).first;
+    CHECK(batch.header_key(custom) == "X-Custom");
+    CHECK(batch.header_ids[custom] == header_id::unknown);
+
+    // The heads tile the parsed bytes
+    CHECK(batch.head(0).data() == buf.data());
+    CHECK(batch.head(1).data() == batch.head(0).data_end());
+    CHECK(batch.head(2).data_end() == batch.parse_tail.data());
+
+    // Parsing again reuses the batch
+    parse_request_batch(neo::const_buffer("GET / HTTP/1.1\r\n\r\n"), batch);
+    CHECK(batch.size() == 1);
+    CHECK(batch.key_offsets.empty());
+    CHECK(batch.parse_tail.empty());
+}
+
+TEST_CASE("A batch stops at a request with a body") {
+    auto buf = neo::const_buffer(
+        "GET / HTTP/1.1\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n"
+        "POST /form HTTP/1.1\r\n"
+        "Content-Length: 9\r\n"
+        "\r\n"
+        "GET / HTTP/1.1\r\n"
+        "\r\n");
+    auto batch = parse_request_batch(buf);
+    REQUIRE(batch.size() == 2);
+    CHECK(batch.stop == stop_reason::body);
+    CHECK(batch.method(1) == "POST");
+    CHECK(std::string_view(batch.parse_tail) == "GET / HTTP/1.1\r\n\r\n");
+}
+
+TEST_CASE("A batch stops at an invalid head") {
+    auto buf = neo::const_buffer(
+        "GET / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "\r\n"
+        "GET / HTTP/1.1\r\n"
+        "Host: b\r\n"
+        "Bad header\r\n"
+        "\r\n");
+    auto batch = parse_request_batch(buf);
+    REQUIRE(batch.size() == 1);
+    CHECK(batch.stop == stop_reason::invalid);
+    CHECK(batch.key_offsets.size() == 1);
+    CHECK(batch.parse_tail.data() == batch.head(0).data_end());
+
+    batch = parse_request_batch(neo::const_buffer("NOT A REQUEST\r\n\r\n"));
+    CHECK(batch.size() == 0);
+    CHECK(batch.stop == stop_reason::invalid);
+}
@@ -5,6 +5,7 @@
 #include <neo/buffer_algorithm.hpp>
 
 #include "./abnf.hpp"
+#include "./scan.hpp"
 #include "./token.hpp"
 #include "./version.hpp"
 
@@ -20,41 +21,27 @@ neo::http::origin_form_target::parse_next(neo::const_buffer buf) noexcept {
 
     const auto full_buf = buf;
 
-    enum pchar_res {
-        pchar_ok,
-        pchar_invalid,
-        pchar_done,
-    };
-
-    auto read_pchar = [&] {
-        if (PCHAR_BASIC_CHARS.contains(char(buf[0]))) {
-            buf += 1;
-            return pchar_ok;
-        }
-        if (buf[0] == std::byte{'%'}) {
-            if (buf.size() < 3) {
-                return pchar_invalid;
+    // Skip a run of `chars` and percent-encoded octets. Returns `false` if we find a malformed
+    // percent-encoding.
+    auto skip_pchars = [&](const char_class& chars) {
+        while (true) {
+            auto stop = skip_class(chars, buf.data(), buf.data_end());
+            buf += static_cast<std::size_t>(stop - buf.data());
+            if (buf.empty() || buf[0] != std::byte{'%'}) {
+                return true;
             }
-            if (HEXDIG.contains(char(buf[1])) && HEXDIG.contains(char(buf[2]))) {
-                buf += 3;
-                return pchar_ok;
+            if (buf.size() < 3 || !HEXDIG.contains(char(buf[1]))
+                || !HEXDIG.contains(char(buf[2]))) {
+                return false;
             }
-            return pchar_invalid;
+            buf += 3;
         }
-        return pchar_done;
     };
 
     while (!buf.empty() && buf[0] == std::byte{'/'}) {
         buf += 1;
-        while (!buf.empty()) {
-            auto pcr = read_pchar();
-            if (pcr == pchar_invalid) {
-                return invalid_ret;
-            } else if (pcr == pchar_done) {
-                break;
-            } else {
-                // More path segment to parse
-            }
+        if (!skip_pchars(PCHAR_BASIC_CHARS)) {
+            return invalid_ret;
         }
     }
 
@@ -65,19 +52,10 @@ neo::http::origin_form_target::parse_next(neo::const_buffer buf) noexcept {
     bool have_query     = !buf.empty() && buf[0] == std::byte{'?'};
     query_full_buf += have_query ? 1 : 0;
 
-    while (!buf.empty()) {
-        if (buf[0] == std::byte{'/'} || buf[0] == std::byte{'?'}) {
-            buf += 1;
-            continue;
-        }
-        auto pcr = read_pchar();
-        if (pcr == pchar_invalid) {
-            return invalid_ret;
-        } else if (pcr == pchar_done) {
-            break;
-        } else {
-            // More query text to parse
-        }
+    // The query may also contain any number of slashes and question marks
+    constexpr static auto query_chars = PCHAR_BASIC_CHARS | char_set<'/', '?'>;
+    if (!skip_pchars(query_chars)) {
+        return invalid_ret;
     }
 
     auto query_len = buf.data() - query_full_buf.data();
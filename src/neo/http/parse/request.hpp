@@ -76,4 +76,6 @@ struct request_line {
 
 struct request_head : message_head<request_head, request_line> {};
 
+using request_head_parser = head_parser<request_head>;
+
 }  // namespace neo::http
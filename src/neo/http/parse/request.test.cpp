@@ -188,3 +188,79 @@ TEST_CASE("Iterate with bad headers") {
     CHECK(iter.at_end());  // We've got a bad header, so the iterator is done
     CHECK_FALSE(iter->valid());
 }
+
+TEST_CASE("Read a request head without any header fields") {
+    std::string_view head
+        = "GET /foo HTTP/1.0\r\n"
+          "\r\n"
+          "GET /bar HTTP/1.0\r\n"
+          "Host: example.com\r\n"
+          "\r\n";
+    auto req_head = neo::http::request_head::parse(neo::const_buffer(head));
+    REQUIRE(req_head.valid());
+    CHECK(req_head.start_line.target.path_view == "/foo");
+    CHECK(req_head.headers.buffer.empty());
+    CHECK(req_head.headers.iter_headers().begin().at_end());
+    // The next (pipelined) request is left in the tail
+    CHECK(std::string_view(req_head.parse_tail).substr(0, 8) == "GET /bar");
+}
+
+TEST_CASE("Incrementally parse a request head") {
+    std::string_view head
+        = "GET /foo/bar?baz HTTP/1.1\r\n"
+          "Content-Length: 20\r\n"
+          "Host: example.com\r\n"
+          "\r\n"
+          "Body";
+    auto expect = neo::http::request_head::parse(neo::const_buffer(head));
+    REQUIRE(expect.valid());
+
+    // Feed the head one more byte at a time, copying to a new buffer each time so that the parser
+    // sees the data move around.
+    neo::http::request_head_parser parser;
+    std::string                    partial;
+    for (auto c : head) {
+        CHECK_FALSE(parser.done());
+        partial.push_back(c);
+        std::string copy = partial;
+        parser.feed(neo::const_buffer(copy));
+        REQUIRE_FALSE(parser.invalid());
+        if (parser.done()) {
+            CHECK(parser.head_size() == head.size() - 4);
+            auto& actual = parser.head();
+            CHECK(actual.start_line.method_view == expect.start_line.method_view);
+            CHECK(actual.start_line.target.path_view == "/foo/bar");
+            CHECK(actual.start_line.target.query_view == "baz");
+            CHECK(std::string_view(actual.headers.buffer)
+                  == std::string_view(expect.headers.buffer));
+            // We stopped feeding at the end of the head:
+            CHECK(actual.parse_tail.empty());
+            break;
+        }
+    }
+    REQUIRE(parser.done());
+    CHECK(parser.header_count() == 2);
+}
+
+TEST_CASE("A malformed header line makes a head invalid") {
+    std::string_view head
+        = "POST / HTTP/1.1\r\n"
+          "Bad line\r\n"
+          "Transfer-Encoding: chunked\r\n"
+          "\r\n";
+    using status = neo::http::request_head_parser::status_t;
+    neo::http::request_head_parser parser;
+    CHECK(parser.feed(neo::const_buffer(head)) == status::invalid);
+
+    // A one-shot parse sees the same problem in the framing, so the fields after the bad line
+    // can't decide how the body is read
+    auto parsed = neo::http::request_head::parse(neo::const_buffer(head));
+    CHECK(parsed.framing.invalid);
+}
+
+TEST_CASE("Incremental parsing rejects a bad start line as soon as it is complete") {
+    using status = neo::http::request_head_parser::status_t;
+    neo::http::request_head_parser parser;
+    CHECK(parser.feed(neo::const_buffer("GET /foo HTTP/5.2")) == status::incomplete);
+    CHECK(parser.feed(neo::const_buffer("GET /foo HTTP/5.2\r\n")) == status::invalid);
+}
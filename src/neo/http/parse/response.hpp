@@ -8,4 +8,6 @@ namespace neo::http {
 
 struct response_head : message_head<response_head, status_line> {};
 
+using response_head_parser = head_parser<response_head>;
+
 }  // namespace neo::http
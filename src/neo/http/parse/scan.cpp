@@ -0,0 +1,223 @@
+#include "./scan.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NEO_HTTP_SCAN_SSE2 1
+#include <emmintrin.h>
+#else
+#define NEO_HTTP_SCAN_SSE2 0
+#endif
+
+#if NEO_HTTP_SCAN_SSE2 && (defined(__GNUC__) || defined(__clang__))
+// GCC and Clang let us compile AVX2 code into individual functions and check for it at runtime
+#define NEO_HTTP_SCAN_AVX2 1
+#include <immintrin.h>
+#else
+#define NEO_HTTP_SCAN_AVX2 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+using namespace neo::http::parse_detail;
+
+namespace {
+
+using scan_fn = const std::byte* (*)(const std::byte*, const std::byte*) noexcept;
+using skip_fn
+    = const std::byte* (*)(const char_class&, const std::byte*, const std::byte*) noexcept;
+
+[[maybe_unused]] int count_trailing_zeros(std::uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx = 0;
+    _BitScanForward(&idx, mask);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#if NEO_HTTP_SCAN_SSE2
+
+inline __m128i load128(const std::byte* p) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+/**
+ * Match the pattern `\r\n` repeated `NPairs` times. Each lane `i` of the comparison checks the
+ * bytes [i, i + NPairs * 2) by loading the block again at each offset of the pattern.
+ */
+template <int NPairs>
+const std::byte* scan_sse2(const std::byte* first, const std::byte* last) noexcept {
+    constexpr int pat_len = NPairs * 2;
+    const auto    cr      = _mm_set1_epi8('\r');
+    const auto    lf      = _mm_set1_epi8('\n');
+    while (last - first >= 16 + pat_len - 1) {
+        auto match = _mm_and_si128(_mm_cmpeq_epi8(load128(first), cr),
+                                   _mm_cmpeq_epi8(load128(first + 1), lf));
+        if constexpr (NPairs == 2) {
+            match = _mm_and_si128(match,
+                                  _mm_and_si128(_mm_cmpeq_epi8(load128(first + 2), cr),
+                                                _mm_cmpeq_epi8(load128(first + 3), lf)));
+        }
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(match));
+        if (mask) {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 16;
+    }
+    if constexpr (NPairs == 1) {
+        return scan_crlf_scalar(first, last);
+    } else {
+        return scan_crlfcrlf_scalar(first, last);
+    }
+}
+
+#endif
+
+#if NEO_HTTP_SCAN_AVX2
+
+__attribute__((target("avx2"))) inline __m256i load256(const std::byte* p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+template <int NPairs>
+__attribute__((target("avx2"))) const std::byte* scan_avx2(const std::byte* first,
+                                                           const std::byte* last) noexcept {
+    constexpr int pat_len = NPairs * 2;
+    const auto    cr      = _mm256_set1_epi8('\r');
+    const auto    lf      = _mm256_set1_epi8('\n');
+    while (last - first >= 32 + pat_len - 1) {
+        auto match = _mm256_and_si256(_mm256_cmpeq_epi8(load256(first), cr),
+                                      _mm256_cmpeq_epi8(load256(first + 1), lf));
+        if constexpr (NPairs == 2) {
+            match = _mm256_and_si256(match,
+                                     _mm256_and_si256(_mm256_cmpeq_epi8(load256(first + 2), cr),
+                                                      _mm256_cmpeq_epi8(load256(first + 3), lf)));
+        }
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+        if (mask) {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 32;
+    }
+    // Finish up any remaining tail with the narrower implementation
+    return scan_sse2<NPairs>(first, last);
+}
+
+/**
+ * Class membership with PSHUFB: look up the low nibble of each byte in the class's nibble table,
+ * and the high nibble in a table of single bits. A byte is a member iff the two results share a
+ * bit. Bytes >= 0x80 look up a zero high-nibble entry, so they are never members.
+ */
+__attribute__((target("ssse3"))) const std::byte*
+skip_class_ssse3(const char_class& cls, const std::byte* first, const std::byte* last) noexcept {
+    const auto lo_tbl = load128(reinterpret_cast<const std::byte*>(cls.lo_nibbles.data()));
+    const auto hi_tbl = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto nibble = _mm_set1_epi8(0x0f);
+    const auto zero   = _mm_setzero_si128();
+    while (last - first >= 16) {
+        auto block = load128(first);
+        auto lo    = _mm_shuffle_epi8(lo_tbl, _mm_and_si128(block, nibble));
+        auto hi    = _mm_shuffle_epi8(hi_tbl, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+        auto miss  = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero);
+        auto mask  = static_cast<std::uint32_t>(_mm_movemask_epi8(miss));
+        if (mask) {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 16;
+    }
+    return skip_class_scalar(cls, first, last);
+}
+
+__attribute__((target("avx2"))) const std::byte*
+skip_class_avx2(const char_class& cls, const std::byte* first, const std::byte* last) noexcept {
+    const auto lo_tbl = _mm256_broadcastsi128_si256(
+        load128(reinterpret_cast<const std::byte*>(cls.lo_nibbles.data())));
+    const auto hi_tbl = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0));
+    const auto nibble = _mm256_set1_epi8(0x0f);
+    const auto zero   = _mm256_setzero_si256();
+    while (last - first >= 32) {
+        auto block = load256(first);
+        auto hi_nib = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+        auto lo     = _mm256_shuffle_epi8(lo_tbl, _mm256_and_si256(block, nibble));
+        auto hi     = _mm256_shuffle_epi8(hi_tbl, hi_nib);
+        auto miss   = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), zero);
+        auto mask   = static_cast<std::uint32_t>(_mm256_movemask_epi8(miss));
+        if (mask) {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 32;
+    }
+    return skip_class_ssse3(cls, first, last);
+}
+
+bool cpu_has_avx2() noexcept {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool cpu_has_ssse3() noexcept {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+
+#endif
+
+template <int NPairs>
+scan_fn select_scan() noexcept {
+#if NEO_HTTP_SCAN_AVX2
+    if (cpu_has_avx2()) {
+        return &scan_avx2<NPairs>;
+    }
+#endif
+#if NEO_HTTP_SCAN_SSE2
+    return &scan_sse2<NPairs>;
+#else
+    if constexpr (NPairs == 1) {
+        return &scan_crlf_scalar;
+    } else {
+        return &scan_crlfcrlf_scalar;
+    }
+#endif
+}
+
+skip_fn select_skip() noexcept {
+#if NEO_HTTP_SCAN_AVX2
+    if (cpu_has_avx2()) {
+        return &skip_class_avx2;
+    }
+    if (cpu_has_ssse3()) {
+        return &skip_class_ssse3;
+    }
+#endif
+    return &skip_class_scalar;
+}
+
+}  // namespace
+
+const std::byte* neo::http::parse_detail::scan_crlf(const std::byte* first,
+                                                    const std::byte* last) noexcept {
+    static const scan_fn impl = select_scan<1>();
+    return impl(first, last);
+}
+
+const std::byte* neo::http::parse_detail::scan_crlfcrlf(const std::byte* first,
+                                                        const std::byte* last) noexcept {
+    static const scan_fn impl = select_scan<2>();
+    return impl(first, last);
+}
+
+const std::byte* neo::http::parse_detail::skip_class(const char_class& cls,
+                                                     const std::byte* first,
+                                                     const std::byte* last) noexcept {
+    static const skip_fn impl = select_skip();
+    // Most runs (methods, short header names) are tiny: Don't bother with the vector setup
+    if (last - first < 16 || !cls.ascii_only()) {
+        return skip_class_scalar(cls, first, last);
+    }
+    return impl(cls, first, last);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "./abnf.hpp"
+
+#include <cstddef>
+
+/**
+ * Byte-scanning primitives shared by the parsers. The non-constexpr versions pick the widest
+ * vector implementation supported by the running CPU (AVX2, SSE2, or plain scalar code).
+ */
+namespace neo::http::parse_detail {
+
+constexpr const std::byte* scan_crlf_scalar(const std::byte* first,
+                                            const std::byte* last) noexcept {
+    for (; last - first >= 2; ++first) {
+        if (first[0] == std::byte{'\r'} && first[1] == std::byte{'\n'}) {
+            return first;
+        }
+    }
+    return last;
+}
+
+constexpr const std::byte* scan_crlfcrlf_scalar(const std::byte* first,
+                                                const std::byte* last) noexcept {
+    for (; last - first >= 4; ++first) {
+        if (first[0] == std::byte{'\r'} && first[1] == std::byte{'\n'}
+            && first[2] == std::byte{'\r'} && first[3] == std::byte{'\n'}) {
+            return first;
+        }
+    }
+    return last;
+}
+
+constexpr const std::byte*
+skip_class_scalar(const char_class& cls, const std::byte* first, const std::byte* last) noexcept {
+    while (first != last && cls.contains(static_cast<char>(*first))) {
+        ++first;
+    }
+    return first;
+}
+
+/// Find the first CRLF in [first, last). Returns `last` if there is no CRLF.
+const std::byte* scan_crlf(const std::byte* first, const std::byte* last) noexcept;
+
+/// Find the first CRLFCRLF in [first, last). Returns `last` if there is no CRLFCRLF.
+const std::byte* scan_crlfcrlf(const std::byte* first, const std::byte* last) noexcept;
+
+/// Skip every byte that is a member of `cls`. Returns the first non-member, or `last`.
+const std::byte*
+skip_class(const char_class& cls, const std::byte* first, const std::byte* last) noexcept;
+
+}  // namespace neo::http::parse_detail
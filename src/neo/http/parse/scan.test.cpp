@@ -0,0 +1,71 @@
+#include <neo/http/parse/common.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+using namespace neo;
+using namespace neo::http;
+
+static_assert(find_crlf(const_buffer()) == -1);
+
+TEST_CASE("Find CRLF sequences") {
+    CHECK(find_crlf(const_buffer("")) == -1);
+    CHECK(find_crlf(const_buffer("\r")) == -1);
+    CHECK(find_crlf(const_buffer("\r\n")) == 0);
+    CHECK(find_crlf(const_buffer("Foo: Bar\r\n")) == 8);
+    CHECK(find_crlf(const_buffer("\n\r\r\n")) == 2);
+
+    CHECK(find_crlfcrlf(const_buffer("\r\n\r")) == -1);
+    CHECK(find_crlfcrlf(const_buffer("\r\n\r\n")) == 0);
+    CHECK(find_crlfcrlf(const_buffer("Foo: Bar\r\n\r\n")) == 8);
+    CHECK(find_crlfcrlf(const_buffer("Foo: Bar\r\nBaz: Q\r\n\r\n")) == 16);
+    CHECK(find_crlfcrlf(const_buffer("\r\r\n\n\r\n\r\r\n\r\n")) == 7);
+}
+
+TEST_CASE("Vectorized scans agree with the scalar scans at every offset") {
+    // Long enough to run through the wide loops and the scalar tail
+    for (std::size_t len : {1u, 3u, 15u, 16u, 17u, 31u, 32u, 33u, 35u, 64u, 100u, 257u}) {
+        for (std::size_t pos = 0; pos < len; ++pos) {
+            for (std::string_view needle : {"\r\n", "\r\n\r\n", "\r", "\r\n\r"}) {
+                std::string str(len, 'x');
+                str.replace(pos, needle.size(), needle);
+                str.resize(len);
+                CAPTURE(len, pos, needle);
+                auto first = reinterpret_cast<const std::byte*>(str.data());
+                auto last  = first + str.size();
+                CHECK(parse_detail::scan_crlf(first, last)
+                      == parse_detail::scan_crlf_scalar(first, last));
+                CHECK(parse_detail::scan_crlfcrlf(first, last)
+                      == parse_detail::scan_crlfcrlf_scalar(first, last));
+            }
+        }
+    }
+}
+
+TEST_CASE("Vectorized class skipping agrees with the scalar skip") {
+    using namespace parse_detail;
+    const char_class* classes[] = {&token_char, &PCHAR_BASIC_CHARS, &WSP, &VCHAR, &HEXDIG};
+    for (auto cls : classes) {
+        for (std::size_t len : {0u, 5u, 16u, 31u, 32u, 47u, 80u}) {
+            for (std::size_t stop = 0; stop <= len; ++stop) {
+                // Fill with members of the class, then plant a non-member
+                std::string str;
+                for (int c = 0; str.size() < len; c = (c + 7) % 256) {
+                    if (cls->contains(char(c))) {
+                        str.push_back(char(c));
+                    }
+                }
+                if (stop < len) {
+                    str[stop] = "\r\x80\x01"[stop % 3];
+                }
+                CAPTURE(len, stop);
+                auto first = reinterpret_cast<const std::byte*>(str.data());
+                auto last  = first + str.size();
+                auto found = skip_class(*cls, first, last);
+                CHECK(found == skip_class_scalar(*cls, first, last));
+                CHECK(found == first + stop);
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace neo::http {
+
+/**
+ * Counts of the work done by the head readers and chunked_buffers, for attributing the cost of
+ * slow parses. See thread_parse_stats.
+ */
+struct parse_stats {
+    /// Message heads read to completion
+    std::uint64_t heads_read = 0;
+    /// Bytes given to a head parser that it had not seen before
+    std::uint64_t head_bytes_scanned = 0;
+    /// Times a head parser was fed again because the head was not complete in what it had seen
+    std::uint64_t head_rescans = 0;
+    /// Bytes of message heads copied out of the input into a buffer
+    std::uint64_t head_bytes_copied = 0;
+    /// Times the buffer holding a copied head was (re)allocated to grow
+    std::uint64_t head_allocations = 0;
+    /// Chunk heads read by chunked_buffers and chunked_span_buffers
+    std::uint64_t chunk_heads = 0;
+    /// Times chunked_buffers had to read more input to see an entire chunk head
+    std::uint64_t chunk_head_retries = 0;
+    /// Bytes of chunk heads that chunked_buffers copied into its pending buffer
+    std::uint64_t chunk_bytes_copied = 0;
+};
+
+/**
+ * The default statistics policy, which records nothing. Every function is empty, so the calls
+ * compile away.
+ *
+ * A statistics policy is a type with the static member functions of this one. It is given as a
+ * template argument to the message readers (read_request(), read_response() and their head-only
+ * forms), which pass it on to the chunked body decoder, and to chunked_buffers,
+ * chunked_span_buffers and make_chunked_source().
+ *
+ * A policy may also have a `static void on_latency(const latency_sample&)` to be told how long
+ * whole operations took. See latency.hpp.
+ */
+struct no_parse_stats {
+    static constexpr void on_head_read() noexcept {}
+    static constexpr void on_head_scanned(std::size_t) noexcept {}
+    static constexpr void on_head_rescan() noexcept {}
+    static constexpr void on_head_copied(std::size_t) noexcept {}
+    static constexpr void on_head_allocation() noexcept {}
+    static constexpr void on_chunk_head() noexcept {}
+    static constexpr void on_chunk_head_retry() noexcept {}
+    static constexpr void on_chunk_copied(std::size_t) noexcept {}
+};
+
+/// A statistics policy that adds to a parse_stats object for the calling thread
+struct thread_parse_stats {
+    /// The counts for the calling thread. Assign `{}` to reset them.
+    static parse_stats& current() noexcept {
+        thread_local parse_stats stats;
+        return stats;
+    }
+
+    static void on_head_read() noexcept { ++current().heads_read; }
+    static void on_head_scanned(std::size_t n) noexcept { current().head_bytes_scanned += n; }
+    static void on_head_rescan() noexcept { ++current().head_rescans; }
+    static void on_head_copied(std::size_t n) noexcept { current().head_bytes_copied += n; }
+    static void on_head_allocation() noexcept { ++current().head_allocations; }
+    static void on_chunk_head() noexcept { ++current().chunk_heads; }
+    static void on_chunk_head_retry() noexcept { ++current().chunk_head_retries; }
+    static void on_chunk_copied(std::size_t n) noexcept { current().chunk_bytes_copied += n; }
+};
+
+}  // namespace neo::http
@@ -1,10 +1,13 @@
 #include "./status.hpp"
 #include "./abnf.hpp"
+#include "./scan.hpp"
 #include "./version.hpp"
 
 #include <neo/buffer_algorithm.hpp>
 
+#include <array>
 #include <charconv>
+#include <cstdint>
 #include <cstring>
 #include <string_view>
 
@@ -64,12 +67,11 @@ neo::http::status_line neo::http::status_line::parse(neo::const_buffer cbuf) noe
         return invalid_ret;
     }
 
-    auto reason_chars = parse_detail::WSP | parse_detail::VCHAR;
-    auto phrase_begin = cbuf.data();
-    // Check each reason phrase char:
-    while (!cbuf.empty() && reason_chars.contains(char(cbuf[0]))) {
-        cbuf += 1;
-    }
+    constexpr static auto reason_chars = parse_detail::WSP | parse_detail::VCHAR;
+    auto                  phrase_begin = cbuf.data();
+    // Skip over the reason phrase chars:
+    auto phrase_end = parse_detail::skip_class(reason_chars, cbuf.data(), cbuf.data_end());
+    cbuf += static_cast<std::size_t>(phrase_end - cbuf.data());
 
     auto phrase = std::string_view(const_buffer(phrase_begin, cbuf.data() - phrase_begin));
 
@@ -84,81 +86,168 @@ neo::http::status_line neo::http::status_line::parse(neo::const_buffer cbuf) noe
     return {ver, status_code, phrase, cbuf};
 }
 
+namespace {
+
+struct phrase_entry {
+    int              code;
+    std::string_view phrase;
+};
+
+constexpr phrase_entry default_phrases[] = {
+    // 1xx
+    {100, "Continue"},
+    {101, "Switching Protocols"},
+    {103, "Early Hints"},
+    // 2xx
+    {200, "Okay"},
+    {201, "Created"},
+    {202, "Accepted"},
+    {203, "Non-Authoritative Information"},
+    {204, "No Content"},
+    {205, "Reset Content"},
+    {206, "Partial Content"},
+    {207, "Multi-Status"},
+    {208, "IM Used"},
+    // 300
+    {300, "Multiple Choices"},
+    {301, "Moved Permanently"},
+    {302, "Found"},
+    {303, "See Other"},
+    {304, "Not Modified"},
+    {305, "Use Proxy"},
+    {306, "Switch Proxy"},
+    {307, "Temporary Redirect"},
+    {308, "Permanent Redirect"},
+    // 4xx
+    {400, "Bad Request"},
+    {401, "Unauthorized"},
+    {402, "Payment Required"},
+    {403, "Forbidden"},
+    {404, "Not Found"},
+    {405, "Method Not Allowed"},
+    {406, "Not Acceptable"},
+    {407, "Proxy Authentication Required"},
+    {408, "Request Timeout"},
+    {409, "Conflict"},
+    {410, "Gone"},
+    {411, "Length Required"},
+    {412, "Precondition Failed"},
+    {413, "Payload Too Large"},
+    {414, "URI Too Long"},
+    {415, "Unsupported Media Type"},
+    {416, "Range Not Satisfiable"},
+    {417, "Expectation Failed"},
+    {418, "I'm a teapot"},
+    {421, "Misdirected Requested"},
+    {422, "Unprocessable Entity"},
+    {423, "Locked"},
+    {424, "Failed Dependency"},
+    {425, "Too Early"},
+    {426, "Upgrade Required"},
+    {428, "Precondition Required"},
+    {429, "Too Many Requests"},
+    {431, "Request Header Fields Too Large"},
+    {451, "Unavailable For Legal Reasons"},
+    // 5xx
+    {500, "Internal Server Error"},
+    {501, "Not Implemented"},
+    {502, "Bad Gateway"},
+    {503, "Service Unavailable"},
+    {504, "Gateway Timeout"},
+    {505, "HTTP Version Not Supported"},
+    {506, "Variant Also Negotiates"},
+    {507, "Insufficient Storage"},
+    {508, "Loop Detected"},
+    {510, "Not Extended"},
+    {511, "Network Authentication Required"},
+};
+
+constexpr std::size_t n_default_phrases = std::size(default_phrases);
+
+// For each status code from 100 to 999, one more than the index of its entry in
+// `default_phrases`, or zero if the code has no default phrase.
+constexpr auto phrase_index = [] {
+    std::array<std::uint8_t, 900> ret = {};
+    for (std::size_t i = 0; i < n_default_phrases; ++i) {
+        ret[static_cast<std::size_t>(default_phrases[i].code - 100)]
+            = static_cast<std::uint8_t>(i + 1);
+    }
+    return ret;
+}();
+
+constexpr std::size_t rendered_lines_size = [] {
+    std::size_t ret = 0;
+    for (auto& entry : default_phrases) {
+        ret += neo::http::status_line{neo::http::version::v1_1, entry.code, entry.phrase}
+                   .required_write_size();
+    }
+    return ret;
+}();
+
+/// Every status line that uses a default phrase, fully rendered for one HTTP version
+struct rendered_lines {
+    std::array<char, rendered_lines_size>            chars   = {};
+    std::array<std::uint16_t, n_default_phrases + 1> offsets = {};
+};
+
+constexpr rendered_lines render_lines(char minor_version) {
+    rendered_lines ret;
+    std::size_t    pos    = 0;
+    auto           append = [&](std::string_view str) {
+        for (char c : str) {
+            ret.chars[pos++] = c;
+        }
+    };
+    for (std::size_t i = 0; i < n_default_phrases; ++i) {
+        auto code      = default_phrases[i].code;
+        ret.offsets[i] = static_cast<std::uint16_t>(pos);
+        append("HTTP/1.");
+        ret.chars[pos++] = minor_version;
+        append(" ");
+        ret.chars[pos++] = static_cast<char>('0' + code / 100);
+        ret.chars[pos++] = static_cast<char>('0' + code / 10 % 10);
+        ret.chars[pos++] = static_cast<char>('0' + code % 10);
+        append(" ");
+        append(default_phrases[i].phrase);
+        append("\r\n");
+    }
+    ret.offsets[n_default_phrases] = static_cast<std::uint16_t>(pos);
+    return ret;
+}
+
+constexpr rendered_lines lines_1_0 = render_lines('0');
+constexpr rendered_lines lines_1_1 = render_lines('1');
+
+std::size_t phrase_index_of(int code) noexcept {
+    if (code < 100 || code > 999) {
+        return 0;
+    }
+    return phrase_index[static_cast<std::size_t>(code - 100)];
+}
+
+}  // namespace
+
 std::string_view neo::http::default_phrase(int code) noexcept {
-    switch (code) {
-#define PHRASE(Num, Phrase)                                                                        \
-    case Num:                                                                                      \
-        return Phrase
-        // 1xx
-        PHRASE(100, "Continue");
-        PHRASE(101, "Switching Protocols");
-        PHRASE(103, "Early Hints");
-        // 2xx
-        PHRASE(200, "Okay");
-        PHRASE(201, "Created");
-        PHRASE(202, "Accepted");
-        PHRASE(203, "Non-Authoritative Information");
-        PHRASE(204, "No Content");
-        PHRASE(205, "Reset Content");
-        PHRASE(206, "Partial Content");
-        PHRASE(207, "Multi-Status");
-        PHRASE(208, "IM Used");
-        // 300
-        PHRASE(300, "Multiple Choices");
-        PHRASE(301, "Moved Permanently");
-        PHRASE(302, "Found");
-        PHRASE(303, "See Other");
-        PHRASE(304, "Not Modified");
-        PHRASE(305, "Use Proxy");
-        PHRASE(306, "Switch Proxy");
-        PHRASE(307, "Temporary Redirect");
-        PHRASE(308, "Permanent Redirect");
-        // 4xx
-        PHRASE(400, "Bad Request");
-        PHRASE(401, "Unauthorized");
-        PHRASE(402, "Payment Required");
-        PHRASE(403, "Forbidden");
-        PHRASE(404, "Not Found");
-        PHRASE(405, "Method Not Allowed");
-        PHRASE(406, "Not Acceptable");
-        PHRASE(407, "Proxy Authentication Required");
-        PHRASE(408, "Request Timeout");
-        PHRASE(409, "Conflict");
-        PHRASE(410, "Gone");
-        PHRASE(411, "Length Required");
-        PHRASE(412, "Precondition Failed");
-        PHRASE(413, "Payload Too Large");
-        PHRASE(414, "URI Too Long");
-        PHRASE(415, "Unsupported Media Type");
-        PHRASE(416, "Range Not Satisfiable");
-        PHRASE(417, "Expectation Failed");
-        PHRASE(418, "I'm a teapot");
-        PHRASE(421, "Misdirected Requested");
-        PHRASE(422, "Unprocessable Entity");
-        PHRASE(423, "Locked");
-        PHRASE(424, "Failed Dependency");
-        PHRASE(425, "Too Early");
-        PHRASE(426, "Upgrade Required");
-        PHRASE(428, "Precondition Required");
-        PHRASE(429, "Too Many Requests");
-        PHRASE(431, "Request Header Fields Too Large");
-        PHRASE(451, "Unavailable For Legal Reasons");
-        // 5xx
-        PHRASE(500, "Internal Server Error");
-        PHRASE(501, "Not Implemented");
-        PHRASE(502, "Bad Gateway");
-        PHRASE(503, "Service Unavailable");
-        PHRASE(504, "Gateway Timeout");
-        PHRASE(505, "HTTP Version Not Supported");
-        PHRASE(506, "Variant Also Negotiates");
-        PHRASE(507, "Insufficient Storage");
-        PHRASE(508, "Loop Detected");
-        PHRASE(510, "Not Extended");
-        PHRASE(511, "Network Authentication Required");
-    default:
-        return "";
-#undef PHRASE
+    auto idx = phrase_index_of(code);
+    return idx == 0 ? std::string_view() : default_phrases[idx - 1].phrase;
+}
+
+neo::const_buffer neo::http::prerendered_status_line(version ver, int code) noexcept {
+    auto idx = phrase_index_of(code);
+    if (idx == 0 || (ver != version::v1_0 && ver != version::v1_1)) {
+        return {};
+    }
+    auto& lines = ver == version::v1_0 ? lines_1_0 : lines_1_1;
+    auto  begin = lines.offsets[idx - 1];
+    auto  end   = lines.offsets[idx];
+    return const_buffer(byte_pointer(lines.chars.data() + begin), end - begin);
+}
+
+neo::const_buffer neo::http::status_line::prerendered() const noexcept {
+    if (phrase_view != default_phrase(status)) {
+        return {};
     }
+    return prerendered_status_line(http_version, status);
 }
 
 neo::mutable_buffer neo::http::status_line::write(neo::mutable_buffer out) const noexcept {
@@ -169,6 +258,10 @@ neo::mutable_buffer neo::http::status_line::write(neo::mutable_buffer out) const
                out.size(),
                required_write_size());
 
+    if (auto line = prerendered(); !line.empty()) {
+        return out + buffer_copy(out, line);
+    }
+
     char status_chars[3];
     std::to_chars(status_chars, status_chars + 3, status);
 
@@ -24,6 +24,12 @@ struct status_line {
 
     mutable_buffer write(mutable_buffer) const noexcept;
 
+    /**
+     * If this line uses the default phrase for its status, the entire line (including the CRLF)
+     * from a static table. Otherwise an empty buffer.
+     */
+    const_buffer prerendered() const noexcept;
+
     constexpr std::size_t required_write_size() const noexcept {
         return version_buf_size + 1    // +1 for SP
             + 3 + 1                    // +3 for code, +1 for SP
@@ -33,4 +39,10 @@ struct status_line {
 
 std::string_view default_phrase(int code) noexcept;
 
+/**
+ * Get the complete status line "HTTP/1.x NNN <default phrase>\r\n" for the given version and
+ * status from a static table. Returns an empty buffer if the status has no default phrase.
+ */
+const_buffer prerendered_status_line(version ver, int code) noexcept;
+
 }  // namespace neo::http
@@ -69,3 +69,36 @@ TEST_CASE("Write statuses") {
     CHECK(retbuf.empty());
     CHECK(str == "HTTP/1.1 200 Okey Dokey\r\n");
 }
+
+TEST_CASE("Prerendered status lines") {
+    using neo::http::version;
+    CHECK(std::string_view(neo::http::prerendered_status_line(version::v1_1, 200))
+          == "HTTP/1.1 200 Okay\r\n");
+    CHECK(std::string_view(neo::http::prerendered_status_line(version::v1_0, 404))
+          == "HTTP/1.0 404 Not Found\r\n");
+    CHECK(std::string_view(neo::http::prerendered_status_line(version::v1_1, 511))
+          == "HTTP/1.1 511 Network Authentication Required\r\n");
+    CHECK(neo::http::prerendered_status_line(version::v1_1, 299).empty());
+    CHECK(neo::http::prerendered_status_line(version::v1_1, 42).empty());
+    CHECK(neo::http::default_phrase(418) == "I'm a teapot");
+    CHECK(neo::http::default_phrase(299) == "");
+
+    // Every prerendered line is what write() would have produced
+    for (int code = 100; code < 1000; ++code) {
+        for (auto ver : {version::v1_0, version::v1_1}) {
+            neo::http::status_line line{ver, code, neo::http::default_phrase(code)};
+            auto                   pre = line.prerendered();
+            CAPTURE(code);
+            if (line.phrase_view.empty()) {
+                CHECK(pre.empty());
+                continue;
+            }
+            CHECK(pre.size() == line.required_write_size());
+            CHECK(neo::http::status_line::parse(pre).phrase_view == line.phrase_view);
+            CHECK(neo::http::status_line::parse(pre).status == code);
+        }
+    }
+
+    neo::http::status_line custom{version::v1_1, 200, "Fine"};
+    CHECK(custom.prerendered().empty());
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "./buffer_pool.hpp"
+#include "./parse/chunked.hpp"
+#include "./parse/framing.hpp"
+#include "./parse/stats.hpp"
+#include "./trace.hpp"
+
+#include <neo/buffer_algorithm/copy.hpp>
+#include <neo/buffer_algorithm/size.hpp>
+#include <neo/buffer_source.hpp>
+#include <neo/concepts.hpp>
+#include <neo/const_buffer.hpp>
+#include <neo/mutable_buffer.hpp>
+#include <neo/ufmt.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace neo::http {
+
+namespace detail {
+
+/**
+ * Accumulates the bytes of a message head in a buffer borrowed from the thread's buffer pool,
+ * which is only acquired once the head turns out to need copying.
+ */
+struct pooled_head_scratch {
+    pooled_buffer buf;
+    std::size_t   size = 0;
+
+    template <typename Bufs>
+    std::size_t append(Bufs&& bufs) {
+        auto want = size + buffer_size(bufs);
+        if (want > buf.size()) {
+            // Move to a larger buffer, and give the old one back to the pool
+            auto bigger = acquire_buffer((std::max)(want, std::size_t(1024)));
+            buffer_copy(bigger.buffer(), bytes());
+            buf = std::move(bigger);
+        }
+        auto n_copied = buffer_copy(buf.buffer() + size, bufs);
+        size += n_copied;
+        return n_copied;
+    }
+
+    const_buffer bytes() const noexcept { return const_buffer(buf.data(), size); }
+};
+
+/// Accumulates the bytes of a message head in caller-provided storage
+struct fixed_head_scratch {
+    mutable_buffer storage;
+    std::size_t    size = 0;
+
+    template <typename Bufs>
+    std::size_t append(Bufs&& bufs) {
+        auto n_copied = buffer_copy(storage + size, bufs);
+        size += n_copied;
+        return n_copied;
+    }
+
+    const_buffer bytes() const noexcept { return storage.first(size); }
+};
+
+constexpr std::size_t max_head_size = 1024 * 1024;
+
+/**
+ * Read a message head from `in` using a head_parser of type `Parser`, and consume exactly the
+ * bytes of the head from `in`.
+ *
+ * If the source can hand out the entire head as a single contiguous buffer, the head is parsed
+ * right where it sits. Otherwise the bytes are accumulated into `scratch` as they arrive. Either
+ * way, `on_head(head, head_bytes)` is called before the head is consumed from the input, and the
+ * views in `head` are only valid for the duration of that call.
+ *
+ * The work done is reported to the statistics policy `Stats` (see no_parse_stats).
+ */
+template <typename Parser,
+          typename Stats = no_parse_stats,
+          buffer_source In,
+          typename Scratch,
+          typename OnHead>
+void read_head(In& in, Scratch& scratch, OnHead&& on_head) {
+    Parser      parser;
+    std::size_t n_fed = 0;
+    NEO_HTTP_PROBE0(head_start);
+
+    // Give the parser what it has been given before, plus `n_new` bytes
+    auto feed = [&](const_buffer buf, std::size_t n_new) {
+        if (n_fed != 0) {
+            Stats::on_head_rescan();
+        }
+        Stats::on_head_scanned(n_new);
+        n_fed += n_new;
+        parser.feed(buf);
+    };
+
+    // Copy into the scratch buffer, noting if it had to grow
+    auto append = [&](auto&& bufs) {
+        auto prev_data = scratch.bytes().data();
+        auto n_copied  = scratch.append(bufs);
+        Stats::on_head_copied(n_copied);
+        if (n_copied != 0 && scratch.bytes().data() != prev_data) {
+            Stats::on_head_allocation();
+        }
+        return n_copied;
+    };
+
+    auto check_parser = [&] {
+        if (parser.invalid()) {
+            throw std::runtime_error("Invalid HTTP message head");
+        }
+    };
+
+    if constexpr (std::is_convertible_v<decltype(in.next(1)), const_buffer>) {
+        std::size_t want = 1024;
+        while (true) {
+            const_buffer peek = in.next(want);
+            feed(peek, peek.size() - n_fed);
+            check_parser();
+            if (parser.done()) {
+                Stats::on_head_read();
+                NEO_HTTP_PROBE1(head_done, parser.head_size());
+                on_head(parser.head(), peek.first(parser.head_size()));
+                in.consume(parser.head_size());
+                return;
+            }
+            if (peek.size() < want || want >= max_head_size) {
+                // The source won't give us any more at once. Switch to copying, keeping the
+                // bytes the parser has already seen.
+                if (append(peek) != peek.size()) {
+                    throw std::runtime_error("HTTP message head is too large for its buffer");
+                }
+                in.consume(peek.size());
+                break;
+            }
+            want *= 2;
+        }
+    }
+
+    // Copy data from the source until the parser sees the end of the head. The parser resumes
+    // where it left off, so each byte is only examined once.
+    while (true) {
+        auto prev_size = scratch.bytes().size();
+        auto n_copied  = append(in.next(1024));
+        if (n_copied == 0) {
+            if (buffer_size(in.next(1)) != 0) {
+                throw std::runtime_error("HTTP message head is too large for its buffer");
+            }
+            throw std::runtime_error("Didn't find terminal CRLF+CRLF for HTTP message head?");
+        }
+        feed(scratch.bytes(), n_copied);
+        check_parser();
+        if (parser.done()) {
+            Stats::on_head_read();
+            NEO_HTTP_PROBE1(head_done, parser.head_size());
+            on_head(parser.head(), scratch.bytes().first(parser.head_size()));
+            // Consume from the input only the amount to get past the CRLFCRLF
+            in.consume(parser.head_size() - prev_size);
+            return;
+        }
+        // Didn't find it yet. Keep looking.
+        in.consume(n_copied);
+        if (scratch.bytes().size() > max_head_size) {
+            throw std::runtime_error(
+                "Didn't find terminal CRLF+CRLF within first 1MB of HTTP message stream. Is this "
+                "an actual HTTP message?");
+        }
+    }
+}
+
+/**
+ * Check the framing that was collected while parsing a head, and copy it without its views of
+ * the head buffer. Throws if the framing is invalid.
+ */
+inline message_framing checked_framing(const message_framing& framing) {
+    if (framing.invalid) {
+        throw std::runtime_error(
+            "Invalid message framing (Content-Length/Transfer-Encoding) in HTTP message head");
+    }
+    NEO_HTTP_PROBE3(framing,
+                    static_cast<int>(framing.has_content_length),
+                    framing.content_length,
+                    static_cast<int>(framing.chunked));
+    auto ret              = framing;
+    ret.transfer_encoding = {};
+    ret.upgrade           = {};
+    return ret;
+}
+
+/**
+ * A factory for the decoder of a body that has a Transfer-Encoding. It is called with the value
+ * of the last Transfer-Encoding field, or with the message's framing, and with the input, and
+ * returns a buffer_source of the decoded body.
+ */
+template <typename F, typename In>
+concept transfer_decoder_factory
+    = (invocable<F, std::string_view&, In>
+       && buffer_source<std::invoke_result_t<F, std::string_view&, In>>)
+    || (invocable<F, const message_framing&, In>
+        && buffer_source<std::invoke_result_t<F, const message_framing&, In>>);
+
+template <typename Factory, typename In>
+decltype(auto) make_transfer_decoder(Factory& factory, const message_framing& framing, In& in) {
+    if constexpr (invocable<Factory&, std::string_view&, In&>) {
+        std::string_view te = framing.transfer_encoding;
+        return factory(te, in);
+    } else {
+        return factory(framing, in);
+    }
+}
+
+/**
+ * The default transfer_decoder_factory, which only knows the chunked coding. If chunked is the
+ * final coding it is removed, and any codings applied before it (e.g. gzip) are left in the body.
+ * The chunked decoder reports to the statistics policy `Stats`.
+ */
+template <typename Stats>
+struct chunked_only_decoder_factory {
+    const char* message_kind;
+
+    template <typename In>
+    auto operator()(const message_framing& framing, In& in) const {
+        if (framing.chunked) {
+            return make_chunked_source<Stats>(in);
+        }
+        throw std::runtime_error(
+            ufmt("{} has a Transfer-Encoding, but no decoders were given to read any encoded "
+                 "data. (Transfer encoding is '{}')",
+                 message_kind,
+                 framing.transfer_encoding));
+    }
+};
+
+}  // namespace detail
+
+}  // namespace neo::http
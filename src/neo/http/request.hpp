@@ -1,6 +1,11 @@
 #pragma once
 
+#include "./gather.hpp"
+#include "./headers.hpp"
+#include "./latency.hpp"
+#include "./parse/chunked.hpp"
 #include "./parse/request.hpp"
+#include "./read_head.hpp"
 
 #include <neo/buffer_algorithm/copy.hpp>
 #include <neo/buffer_algorithm/encode.hpp>
@@ -10,31 +15,150 @@
 #include <neo/switch_coro.hpp>
 
 #include <neo/concepts.hpp>
+#include <neo/ufmt.hpp>
+
+#include <stdexcept>
+#include <string>
 
 namespace neo::http {
 
-template <buffer_output Out, typename Headers, buffer_input Body>
+/**
+ * Write a request head and its body to `out`. The time taken is reported to the statistics policy
+ * `Stats` (see no_parse_stats). Returns the number of bytes written.
+ */
+template <typename Stats = no_parse_stats, buffer_output Out, typename Headers, buffer_input Body>
 std::size_t
 write_request(Out&& out_, const request_line& req_line, Headers&& headers, Body&& body) {
-    using namespace literals;
-    auto&& out       = ensure_buffer_sink(out_);
-    auto   n_written = req_line.write(out);
-
-    for (const auto& [key, value] : headers) {
-        auto&& key_buf = as_buffer(key);
-        auto&& val_buf = as_buffer(value);
-        n_written += buffer_copy(out, buffers_cat(key_buf, ": "_buf, val_buf, "\r\n"_buf));
-    }
+    auto&& out = ensure_buffer_sink(out_);
 
-    n_written += buffer_copy(out, "\r\n"_buf);
-    n_written += buffer_copy(out, body);
+    detail::latency_timer<Stats> timer;
+    gather_buffers               head;
+    gather_request_head(head, req_line, headers);
+    auto head_size = buffer_copy(out, head);
+    auto n_written = head_size + buffer_copy(out, body);
 
+    timer.record(latency_op::write_request, timer.framing_of(headers), head_size);
     return n_written;
 }
 
-template <typename Req, buffer_output Out>
+template <typename Stats = no_parse_stats, typename Req, buffer_output Out>
 std::size_t write_request(Out&& out, Req&& req) {
-    return write_request(out, req.start_line(), req.headers(), req.body());
+    return write_request<Stats>(out, req.start_line(), req.headers(), req.body());
+}
+
+struct simple_request {
+    std::string   method;
+    std::string   target;
+    http::version version = http::version::invalid;
+
+    http::headers headers;
+
+    std::size_t head_byte_size = 0;
+};
+
+template <typename RequestType>
+void assign_request_head(RequestType& ret, const request_head& head, const_buffer head_bytes) {
+    if constexpr (requires { ret.assign_head(head, head_bytes); }) {
+        ret.assign_head(head, head_bytes);
+    } else {
+        auto& target       = head.start_line.target;
+        ret.head_byte_size = head_bytes.size();
+        ret.version        = head.start_line.http_version;
+        ret.method         = std::string(head.start_line.method_view);
+        ret.target         = std::string(target.path_view);
+        if (target.has_query) {
+            ret.target.append("?").append(target.query_view);
+        }
+
+        for (auto header : head.headers.iter_headers()) {
+            if constexpr (requires { ret.headers.add(header.id, "", ""); }) {
+                ret.headers.add(header.id, header.key_view, header.value_view);
+            } else {
+                ret.headers.add(header.key_view, header.value_view);
+            }
+        }
+    }
+}
+
+/**
+ * Read a request head from `in`, consuming exactly the bytes of the head. Any bytes that follow
+ * (the body, or the next pipelined request) are left in the input.
+ *
+ * The work done is reported to the statistics policy `Stats` (see no_parse_stats).
+ */
+template <typename RequestType, typename Stats = no_parse_stats, buffer_input In>
+RequestType read_request_head(In&& in_) {
+    auto&&      in = ensure_buffer_source(in_);
+    RequestType ret;
+
+    detail::pooled_head_scratch scratch;
+    auto on_head = [&](auto& head, const_buffer bytes) {
+        assign_request_head(ret, head, bytes);
+    };
+    detail::read_head<request_head_parser, Stats>(in, scratch, on_head);
+    return ret;
+}
+
+/**
+ * Read a request from `in`, writing its body to `out`. The body is framed by the request's
+ * Transfer-Encoding or Content-Length, and a request with neither has no body (RFC 7230 3.3.3).
+ * Exactly the bytes of the request are consumed from `in`.
+ *
+ * If the request has a Transfer-Encoding, `tr_factory` (a detail::transfer_decoder_factory) must
+ * return a buffer_source of the decoded body.
+ *
+ * Returns the request head.
+ */
+// clang-format off
+template <typename RequestType = simple_request,
+          typename Stats       = no_parse_stats,
+          buffer_output Out,
+          buffer_input In,
+          typename TransformerFactory>
+RequestType read_request(Out&& out_, In&& in_, TransformerFactory&& tr_factory)
+    requires detail::transfer_decoder_factory<TransformerFactory,
+                                              decltype(ensure_buffer_source(in_))&>
+{
+    // clang-format on
+    auto&& in  = ensure_buffer_source(in_);
+    auto&& out = ensure_buffer_sink(out_);
+
+    // The framing was collected while parsing the head, so we don't need to look for it again
+    RequestType                 head;
+    message_framing             framing;
+    std::string                 te_value;
+    detail::pooled_head_scratch scratch;
+    auto on_head = [&](auto& parsed, const_buffer bytes) {
+        assign_request_head(head, parsed, bytes);
+        framing  = detail::checked_framing(parsed.framing);
+        te_value = parsed.framing.transfer_encoding;
+    };
+    detail::read_head<request_head_parser, Stats>(in, scratch, on_head);
+    framing.transfer_encoding = te_value;
+
+    std::size_t n_copied = 0;
+    if (framing.has_transfer_encoding()) {
+        auto&& new_in = detail::make_transfer_decoder(tr_factory, framing, in);
+        n_copied      = buffer_copy(out, new_in);
+    } else if (framing.has_content_length) {
+        auto size = static_cast<std::size_t>(framing.content_length);
+        n_copied  = buffer_copy(out, in, size);
+        if (n_copied != size) {
+            throw std::runtime_error("HTTP request body ended before its Content-Length");
+        }
+    }
+    NEO_HTTP_PROBE1(body_done, n_copied);
+    return head;
+}
+
+template <typename RequestType = simple_request,
+          typename Stats       = no_parse_stats,
+          buffer_output Out,
+          buffer_input In>
+RequestType read_request(Out&& out, In&& in) {
+    return read_request<RequestType, Stats>(out,
+                                            in,
+                                            detail::chunked_only_decoder_factory<Stats>{"Request"});
 }
 
 }  // namespace neo::http
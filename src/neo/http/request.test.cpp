@@ -1,5 +1,6 @@
 #include <neo/http/request.hpp>
 
+#include <neo/pathological_buffer_range.hpp>
 #include <neo/string_io.hpp>
 
 #include <catch2/catch.hpp>
@@ -33,4 +34,166 @@ TEST_CASE("Write a simple request") {
         "User-Agent: Test client\r\n"
         "\r\n"
         );
+
+    // With a statistics policy, the latency is recorded under the framing of the headers
+    auto before = neo::http::snapshot_latencies().total(neo::http::latency_op::write_request);
+    neo::string_dynbuf_io timed;
+    neo::http::write_request<neo::http::thread_latency_stats>(timed, req);
+    CHECK(timed.read_area_view() == str.read_area_view());
+    auto after = neo::http::snapshot_latencies().get(neo::http::latency_op::write_request,
+                                                     neo::http::body_framing::none,
+                                                     neo::http::head_size_class::lt256);
+    CHECK(after.count() >= 1);
+    CHECK(neo::http::snapshot_latencies().total(neo::http::latency_op::write_request).count()
+          == before.count() + 1);
+}
+
+TEST_CASE("Read a request head") {
+    auto req_str = neo::const_buffer(
+        "POST /foo/bar?baz=1 HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "Hello");
+    neo::http::simple_request req;
+
+    SECTION("Single contiguous buffer") {
+        req = neo::http::read_request_head<neo::http::simple_request>(req_str);
+    }
+    SECTION("Pathological buffer") {
+        req = neo::http::read_request_head<neo::http::simple_request>(
+            neo::pathological_buffer_range(req_str));
+    }
+
+    CHECK(req.method == "POST");
+    CHECK(req.target == "/foo/bar?baz=1");
+    CHECK(req.version == neo::http::version::v1_1);
+    CHECK(req.headers["host"].value == "example.com");
+    CHECK(req.head_byte_size == 70);
+    CHECK(std::string_view(req_str + req.head_byte_size) == "Hello");
+}
+
+TEST_CASE("Read pipelined requests") {
+    neo::string_dynbuf_io in;
+    neo::buffer_copy(in, neo::const_buffer(
+        "POST /upload HTTP/1.1\r\n"
+        "Content-Length: 12\r\n"
+        "\r\n"
+        "Message body"
+        "PUT /chunks HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nHello\r\n"
+        "6\r\n world\r\n"
+        "0\r\n\r\n"
+        "GET / HTTP/1.1\r\n"
+        "\r\n"
+        "[Next]"));
+
+    neo::string_dynbuf_io body;
+
+    auto req = neo::http::read_request(body, in);
+    CHECK(req.method == "POST");
+    CHECK(body.read_area_view() == "Message body");
+
+    body.clear();
+    req = neo::http::read_request(body, in);
+    CHECK(req.method == "PUT");
+    CHECK(req.target == "/chunks");
+    CHECK(body.read_area_view() == "Hello world");
+
+    body.clear();
+    req = neo::http::read_request(body, in);
+    CHECK(req.method == "GET");
+    CHECK(body.read_area_view() == "");
+    CHECK(in.read_area_view() == "[Next]");
+}
+
+TEST_CASE("Read requests with any chunked Transfer-Encoding") {
+    auto te = GENERATE(std::string("Transfer-Encoding: Chunked\r\n"),
+                       std::string("Transfer-Encoding: gzip, chunked\r\n"),
+                       std::string("Transfer-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n"));
+    CAPTURE(te);
+    auto req_str = "PUT / HTTP/1.1\r\n" + te + "\r\n5\r\nHello\r\n0\r\n\r\n";
+
+    neo::string_dynbuf_io body;
+    auto req = neo::http::read_request(body, neo::const_buffer(req_str));
+    CHECK(req.method == "PUT");
+    CHECK(body.read_area_view() == "Hello");
+
+    body.clear();
+    neo::http::read_request(body, neo::pathological_buffer_range{neo::const_buffer(req_str)});
+    CHECK(body.read_area_view() == "Hello");
+}
+
+TEST_CASE("Count the work done reading a request") {
+    auto req_str = neo::const_buffer(
+        "PUT / HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nHello\r\n"
+        "0\r\n\r\n");
+    using stats      = neo::http::thread_parse_stats;
+    stats::current() = {};
+
+    neo::string_dynbuf_io body;
+    neo::http::read_request<neo::http::simple_request, stats>(body, req_str);
+    CHECK(body.read_area_view() == "Hello");
+    CHECK(stats::current().heads_read == 1);
+    CHECK(stats::current().chunk_heads == 2);
+
+    stats::current() = {};
+    body.clear();
+    neo::http::read_request<neo::http::simple_request, stats>(body,
+                                                              neo::pathological_buffer_range(
+                                                                  req_str));
+    CHECK(body.read_area_view() == "Hello");
+    CHECK(stats::current().heads_read == 1);
+    CHECK(stats::current().chunk_heads == 2);
+}
+
+TEST_CASE("Reject requests with bad framing") {
+    neo::string_dynbuf_io body;
+    CHECK_THROWS(neo::http::read_request(body,
+                                         neo::const_buffer("POST / HTTP/1.1\r\n"
+                                                           "Content-Length: 12x\r\n"
+                                                           "\r\n")));
+    CHECK_THROWS(neo::http::read_request(body,
+                                         neo::const_buffer("POST / HTTP/1.1\r\n"
+                                                           "Content-Length: 12\r\n"
+                                                           "\r\n"
+                                                           "Too short")));
+    CHECK_THROWS(neo::http::read_request(body,
+                                         neo::const_buffer("POST / HTTP/1.1\r\n"
+                                                           "Transfer-Encoding: gzip\r\n"
+                                                           "\r\n")));
+    // A smuggling attempt
+    CHECK_THROWS(neo::http::read_request(body,
+                                         neo::const_buffer("POST / HTTP/1.1\r\n"
+                                                           "Content-Length: 5\r\n"
+                                                           "Transfer-Encoding: chunked\r\n"
+                                                           "\r\n"
+                                                           "0\r\n\r\n")));
+    // A malformed line would hide the Transfer-Encoding from the parsed headers
+    CHECK_THROWS(neo::http::read_request(body,
+                                         neo::const_buffer("POST / HTTP/1.1\r\n"
+                                                           "Bad line\r\n"
+                                                           "Transfer-Encoding: chunked\r\n"
+                                                           "\r\n"
+                                                           "0\r\n\r\n")));
+    CHECK_THROWS(neo::http::read_request(body,
+                                         neo::pathological_buffer_range(
+                                             neo::const_buffer("POST / HTTP/1.1\r\n"
+                                                               "Bad line\r\n"
+                                                               "Transfer-Encoding: chunked\r\n"
+                                                               "\r\n"
+                                                               "0\r\n\r\n"))));
+
+    // Enough Transfer-Encoding fields to overflow a narrow counter must not hide them
+    std::string many_te = "POST / HTTP/1.1\r\nContent-Length: 5\r\n";
+    for (int i = 0; i < 256; ++i) {
+        many_te += "Transfer-Encoding: chunked\r\n";
+    }
+    many_te += "\r\n0\r\n\r\n";
+    CHECK_THROWS(neo::http::read_request(body, neo::const_buffer(many_te)));
 }
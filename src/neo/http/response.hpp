@@ -1,17 +1,24 @@
 #pragma once
 
+#include "./body_source.hpp"
+#include "./borrowed_response.hpp"
+#include "./gather.hpp"
 #include "./headers.hpp"
+#include "./latency.hpp"
+#include "./read_head.hpp"
 #include "./parse/chunked.hpp"
+#include <neo/http/parse/common.hpp>
 #include <neo/http/parse/header.hpp>
 #include <neo/http/parse/response.hpp>
 #include <neo/http/version.hpp>
 
 #include <neo/buffer_source.hpp>
-#include <neo/string_io.hpp>
 #include <neo/transform_io.hpp>
 #include <neo/ufmt.hpp>
 
 #include <map>
+#include <stdexcept>
+#include <type_traits>
 
 namespace neo::http {
 
@@ -25,94 +32,183 @@ struct simple_response {
     std::size_t head_byte_size = 0;
 };
 
-template <typename ResponseType, buffer_input In>
-ResponseType read_response_head(In&& in_) {
-    neo::string_dynbuf_io strbuf;
+template <typename ResponseType>
+void assign_response_head(ResponseType& ret, const response_head& head, const_buffer head_bytes) {
+    if constexpr (requires { ret.assign_head(head, head_bytes); }) {
+        ret.assign_head(head, head_bytes);
+    } else {
+        ret.head_byte_size = head_bytes.size();
+        ret.version        = head.start_line.http_version;
+        ret.status         = head.start_line.status;
+        ret.status_message = std::string(head.start_line.phrase_view);
+
+        for (auto header : head.headers.iter_headers()) {
+            if constexpr (requires { ret.headers.add(header.id, "", ""); }) {
+                // Keep the id from parsing so the container need not classify the key again
+                ret.headers.add(header.id, header.key_view, header.value_view);
+            } else {
+                ret.headers.add(header.key_view, header.value_view);
+            }
+        }
+    }
+}
 
+/**
+ * Read a response head from `in`, consuming exactly the bytes of the head. The work done, and the
+ * time taken, are reported to the statistics policy `Stats` (see no_parse_stats).
+ */
+template <typename ResponseType, typename Stats = no_parse_stats, buffer_input In>
+ResponseType read_response_head(In&& in_) {
     auto&&       in = ensure_buffer_source(in_);
     ResponseType ret;
 
-    // Copy data from the source until we find the ending CRLFCRLF sequence
-    const std::string_view END_SEQ = "\r\n\r\n";
-    while (true) {
-        auto prev_avail = strbuf.available();
-        auto n_copied   = buffer_copy(strbuf, in.next(1024));
-        if (n_copied == 0) {
-            throw std::runtime_error("Didn't find terminal CRLF+CRLF for HTTP response-head?");
-        }
-        if (auto end_pos = strbuf.read_area_view().find(END_SEQ);
-            end_pos != std::string_view::npos) {
-            // Consume from the input only the amount to get past the CRLFCRLF
-            auto head_end = end_pos + END_SEQ.size();
-            auto fin_size = head_end - prev_avail;
-            ret.head_byte_size += fin_size;
-            in.consume(fin_size);
-            break;
-        }
-        // Didn't find it yet. Keep looking.
-        ret.head_byte_size += n_copied;
-        in.consume(n_copied);
-        if (strbuf.available() > 1024 * 1024) {
-            throw std::runtime_error(
-                "Didn't find terminal CRLF+CRLF within first 1MB of HTTP response stream. Is this "
-                "an actual HTTP response?");
-        }
-    }
-
-    auto head = response_head::parse(const_buffer(strbuf.read_area_view()));
+    detail::latency_timer<Stats> timer;
+    detail::pooled_head_scratch  scratch;
+    auto on_head = [&](auto& head, const_buffer bytes) {
+        assign_response_head(ret, head, bytes);
+        timer.record(latency_op::read_response_head, classify_framing(head.framing), bytes.size());
+    };
+    detail::read_head<response_head_parser, Stats>(in, scratch, on_head);
+    return ret;
+}
 
-    ret.version        = head.start_line.http_version;
-    ret.status         = head.start_line.status;
-    ret.status_message = std::string(head.start_line.phrase_view);
+/// A response head, and a source for the body that follows it
+template <typename ResponseType, buffer_source In>
+struct response_with_body {
+    ResponseType    head;
+    body_source<In> body;
+};
 
-    for (auto header : head.headers.iter_headers()) {
-        ret.headers.add(header.key_view, header.value_view);
-    }
+/**
+ * Read a response head from `in`, and return it along with a body_source that reads the body
+ * directly from `in` as the caller pulls on it. `in` must outlive the returned body.
+ */
+template <typename ResponseType = simple_response,
+          typename Stats        = no_parse_stats,
+          buffer_source In>
+response_with_body<ResponseType, In> read_response_head_and_body(In& in) {
+    ResponseType    head;
+    message_framing framing;
+    int             status = 0;
+
+    detail::pooled_head_scratch scratch;
+    auto on_head = [&](auto& parsed, const_buffer bytes) {
+        assign_response_head(head, parsed, bytes);
+        framing = detail::checked_framing(parsed.framing);
+        status  = parsed.start_line.status;
+    };
+    detail::read_head<response_head_parser, Stats>(in, scratch, on_head);
+    return {std::move(head), body_source<In>::for_response(in, framing, status)};
+}
 
+/**
+ * Read a response head into the caller's `storage`, without allocating. The returned response
+ * refers to `storage`, which must outlive it. Throws if the head does not fit.
+ */
+template <typename Stats = no_parse_stats, buffer_input In>
+borrowed_response read_response_head_into(mutable_buffer storage, In&& in_) {
+    auto&&            in = ensure_buffer_source(in_);
+    borrowed_response ret;
+
+    detail::fixed_head_scratch scratch{storage};
+    auto on_head = [&](auto& head, const_buffer bytes) {
+        if (bytes.data() != storage.data()) {
+            // We parsed the head directly from the source. Move it into the storage.
+            if (bytes.size() > storage.size()) {
+                throw std::runtime_error("HTTP response head is too large for its buffer");
+            }
+            buffer_copy(storage, bytes);
+            ret = borrowed_response::borrow(head, bytes, storage.first(bytes.size()));
+        } else {
+            ret = borrowed_response::borrow(head, bytes);
+        }
+    };
+    detail::read_head<response_head_parser, Stats>(in, scratch, on_head);
     return ret;
 }
 
+/**
+ * Read a response from `in`, writing its body to `out`. If the response has a Transfer-Encoding,
+ * `tr_factory` (a detail::transfer_decoder_factory) must return a buffer_source of the decoded
+ * body.
+ *
+ * The time taken to read the head, and then to transfer the body, are reported to the statistics
+ * policy `Stats` (see no_parse_stats). Returns the number of bytes written to `out`.
+ */
 // clang-format off
-template <buffer_output Out, buffer_input In, typename TransformerFactory>
+template <typename Stats = no_parse_stats,
+          buffer_output Out,
+          buffer_input In,
+          typename TransformerFactory>
 std::size_t read_response(Out&& out_, In&& in_, TransformerFactory&& tr_factory)
-    requires (
-        invocable<TransformerFactory,
-                  std::string_view&,
-                  decltype(ensure_buffer_source(in_))&> &&
-        buffer_source<
-            std::invoke_result_t<TransformerFactory,
-                                 std::string_view&,
-                                 decltype(ensure_buffer_source(in_))&>>
-    )
+    requires detail::transfer_decoder_factory<TransformerFactory,
+                                              decltype(ensure_buffer_source(in_))&>
 {
     // clang-format on
     auto&& in  = ensure_buffer_source(in_);
     auto&& out = ensure_buffer_sink(out_);
 
-    auto head = read_response_head<simple_response>(in);
-    auto clen = head.headers.find(standard_headers::content_length);
-    auto te   = head.headers.find(standard_headers::transfer_encoding);
-
-    if (te) {
-        auto&& new_in = tr_factory(te->value, in);
-        return buffer_copy(out, new_in);
-    } else if (clen) {
-        return buffer_copy(out, in, std::stoi(clen->value));
+    // The framing was collected while parsing the head, so we don't need to look for it again
+    simple_response              head;
+    message_framing              framing;
+    std::string                  te_value;
+    detail::latency_timer<Stats> timer;
+    detail::pooled_head_scratch  scratch;
+    auto on_head = [&](auto& parsed, const_buffer bytes) {
+        assign_response_head(head, parsed, bytes);
+        framing  = detail::checked_framing(parsed.framing);
+        te_value = parsed.framing.transfer_encoding;
+    };
+    detail::read_head<response_head_parser, Stats>(in, scratch, on_head);
+    framing.transfer_encoding = te_value;
+
+    auto framing_kind = classify_framing(framing);
+    timer.record(latency_op::read_response_head, framing_kind, head.head_byte_size);
+    timer.restart();
+
+    std::size_t n_copied = 0;
+    if (framing.has_transfer_encoding()) {
+        auto&& new_in = detail::make_transfer_decoder(tr_factory, framing, in);
+        n_copied      = buffer_copy(out, new_in);
+    } else if (framing.has_content_length) {
+        n_copied = buffer_copy(out, in, static_cast<std::size_t>(framing.content_length));
     }
-    return 0;
+    timer.record(latency_op::read_response_body, framing_kind, head.head_byte_size);
+    NEO_HTTP_PROBE1(body_done, n_copied);
+    return n_copied;
 }
 
-template <buffer_output Out, buffer_input In>
+template <typename Stats = no_parse_stats, buffer_output Out, buffer_input In>
 std::size_t read_response(Out&& out, In&& in) {
-    return read_response(out, in, [](std::string_view te, auto&& in) {
-        if (te == "chunked") {
-            return chunked_buffers{in};
-        }
-        throw std::runtime_error(
-            ufmt("Response has a Transport-Encoding, but no decoders were given to read any "
-                 "encoded data. (Transport encoding is '{}')",
-                 te));
-    });
+    return read_response<Stats>(out, in, detail::chunked_only_decoder_factory<Stats>{"Response"});
+}
+
+template <buffer_output Out, typename Headers, buffer_input Body>
+std::size_t
+write_response(Out&& out_, const status_line& status, Headers&& headers, Body&& body) {
+    auto&& out = ensure_buffer_sink(out_);
+
+    gather_buffers head;
+    gather_response_head(head, status, headers);
+    auto n_written = buffer_copy(out, head);
+    n_written += buffer_copy(out, body);
+
+    return n_written;
+}
+
+/**
+ * Write a response with the default phrase for `status`. The status line for common codes is
+ * copied from a static table without any formatting.
+ */
+template <buffer_output Out, typename Headers, buffer_input Body>
+std::size_t
+write_response(Out&& out, http::version ver, int status, Headers&& headers, Body&& body) {
+    return write_response(out, status_line{ver, status, default_phrase(status)}, headers, body);
+}
+
+template <typename Resp, buffer_output Out>
+std::size_t write_response(Out&& out, Resp&& resp) {
+    return write_response(out, resp.start_line(), resp.headers(), resp.body());
 }
 
 }  // namespace neo::http
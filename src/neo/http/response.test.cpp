@@ -1,9 +1,12 @@
 #include <neo/http/response.hpp>
 
 #include <neo/pathological_buffer_range.hpp>
+#include <neo/string_io.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <array>
+
 TEST_CASE("Read a basic HTTP response") {
     auto res_str = neo::const_buffer(
         "HTTP/1.1 200 Okay\r\n"
@@ -31,6 +34,70 @@ TEST_CASE("Read a basic HTTP response") {
     CHECK(std::string_view(body_buf) == "Message body");
 }
 
+TEST_CASE("Count the work done reading a response head") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 200 Okay\r\n"
+        "Content-Length: 12\r\n"
+        "\r\n"
+        "Message body");
+    using stats = neo::http::thread_parse_stats;
+    stats::current() = {};
+
+    neo::http::read_response_head<neo::http::simple_response, stats>(res_str);
+    CHECK(stats::current().heads_read == 1);
+    CHECK(stats::current().head_bytes_scanned == res_str.size());
+    CHECK(stats::current().head_rescans == 0);
+    CHECK(stats::current().head_bytes_copied == 0);
+
+    // A fragmented input makes the reader copy the head out of it
+    stats::current() = {};
+    neo::http::read_response_head<neo::http::simple_response, stats>(
+        neo::pathological_buffer_range(res_str));
+    CHECK(stats::current().heads_read == 1);
+    CHECK(stats::current().head_bytes_copied >= 41);
+    CHECK(stats::current().head_bytes_scanned == stats::current().head_bytes_copied);
+
+    // Without a policy, nothing is counted
+    stats::current() = {};
+    neo::http::read_response_head<neo::http::simple_response>(res_str);
+    CHECK(stats::current().heads_read == 0);
+}
+
+TEST_CASE("Count the chunk heads of a response body") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 200 Okay\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nHello\r\n"
+        "6\r\n world\r\n"
+        "0\r\n\r\n");
+    using stats      = neo::http::thread_parse_stats;
+    stats::current() = {};
+
+    neo::string_dynbuf_io body_io;
+    neo::http::read_response<stats>(body_io, res_str);
+    CHECK(body_io.read_area_view() == "Hello world");
+    CHECK(stats::current().heads_read == 1);
+    CHECK(stats::current().chunk_heads == 3);
+
+    stats::current() = {};
+    std::array<std::byte, 256> storage;
+    neo::http::read_response_head_into<stats>(neo::mutable_buffer(storage), res_str);
+    CHECK(stats::current().heads_read == 1);
+}
+
+TEST_CASE("Reading a fragmented response head reuses a pooled buffer") {
+    auto res_str = neo::const_buffer("HTTP/1.1 204 No Content\r\n\r\n");
+    neo::http::trim_buffer_pool();
+    for (int i = 0; i < 3; ++i) {
+        auto resp = neo::http::read_response_head<neo::http::simple_response>(
+            neo::pathological_buffer_range(res_str));
+        CHECK(resp.status == 204);
+        // The buffer that the head was copied into is back in the pool
+        CHECK(neo::http::buffer_pool_cached_bytes() == 1024);
+    }
+}
+
 TEST_CASE("Read an HTTP response with a body") {
     auto res_str = neo::const_buffer(
         "HTTP/1.1 200 Okay\r\n"
@@ -100,3 +167,193 @@ TEST_CASE("Read an chunked HTTP response with a body") {
     CHECK(nread == 34);
     CHECK(body_io.read_area_view() == "Message body\nI am on another line\n");
 }
+
+TEST_CASE("The chunked coding is found in any Transfer-Encoding") {
+    auto te = GENERATE(std::string("Transfer-Encoding: Chunked\r\n"),
+                       std::string("Transfer-Encoding: gzip, chunked\r\n"),
+                       std::string("Transfer-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n"));
+    CAPTURE(te);
+    auto res_str = "HTTP/1.1 200 Okay\r\n" + te + "\r\n5\r\nHello\r\n0\r\n\r\n[Next]";
+
+    neo::string_dynbuf_io body_io;
+    auto nread = neo::http::read_response(body_io, neo::const_buffer(res_str));
+    CHECK(nread == 5);
+    CHECK(body_io.read_area_view() == "Hello");
+
+    body_io.clear();
+    nread = neo::http::read_response(body_io,
+                                     neo::pathological_buffer_range{neo::const_buffer(res_str)});
+    CHECK(nread == 5);
+    CHECK(body_io.read_area_view() == "Hello");
+}
+
+TEST_CASE("A transfer decoder factory is given the message framing") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 200 Okay\r\n"
+        "Transfer-Encoding: identity\r\n"
+        "Transfer-Encoding: x-custom\r\n"
+        "\r\n"
+        "Hello");
+    neo::string_dynbuf_io body_io;
+    auto nread = neo::http::read_response(body_io,
+                                          res_str,
+                                          [](const neo::http::message_framing& framing, auto& in) {
+                                              CHECK(framing.transfer_encoding == "x-custom");
+                                              CHECK(framing.transfer_encoding_fields == 2);
+                                              CHECK_FALSE(framing.chunked);
+                                              return in;
+                                          });
+    CHECK(nread == 5);
+    CHECK(body_io.read_area_view() == "Hello");
+}
+
+TEST_CASE("Read a borrowed HTTP response head") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 404 Not Found\r\n"
+        "Content-Length: 12\r\n"
+        "Content-Disposition: lol test\r\n"
+        "\r\n"
+        "Message body");
+
+    neo::http::borrowed_response resp;
+    std::array<std::byte, 256>   storage;
+
+    SECTION("Owning, from a single contiguous buffer") {
+        resp = neo::http::read_response_head<neo::http::borrowed_response>(res_str);
+        CHECK(resp.owns_buffer());
+    }
+    SECTION("Owning, from a pathological buffer") {
+        resp = neo::http::read_response_head<neo::http::borrowed_response>(
+            neo::pathological_buffer_range(res_str));
+        CHECK(resp.owns_buffer());
+    }
+    SECTION("Caller storage, from a single contiguous buffer") {
+        resp = neo::http::read_response_head_into(neo::mutable_buffer(storage.data(), 256),
+                                                  res_str);
+        CHECK_FALSE(resp.owns_buffer());
+        CHECK(resp.head_bytes().data() == storage.data());
+    }
+    SECTION("Caller storage, from a pathological buffer") {
+        resp = neo::http::read_response_head_into(neo::mutable_buffer(storage.data(), 256),
+                                                  neo::pathological_buffer_range(res_str));
+        CHECK_FALSE(resp.owns_buffer());
+        CHECK(resp.head_bytes().data() == storage.data());
+    }
+
+    CHECK(resp.status == 404);
+    CHECK(resp.status_message == "Not Found");
+    CHECK(resp.version == neo::http::version::v1_1);
+    CHECK(resp.head_byte_size == 77);
+    REQUIRE(resp.find_header("content-length"));
+    CHECK(resp.find_header("content-length")->value_view == "12");
+    CHECK(resp.find_header("Content-Disposition")->value_view == "lol test");
+    CHECK_FALSE(resp.find_header("Transfer-Encoding"));
+
+    // Copies share the same head bytes
+    auto copy = resp;
+    CHECK(copy.head_bytes().data() == resp.head_bytes().data());
+    CHECK(copy.status_message.data() == resp.status_message.data());
+}
+
+TEST_CASE("Reading a response head into storage that is too small") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 200 Okay\r\n"
+        "Content-Length: 12\r\n"
+        "\r\n");
+    std::array<std::byte, 16> storage;
+    CHECK_THROWS(neo::http::read_response_head_into(neo::mutable_buffer(storage.data(), 16),
+                                                    res_str));
+    CHECK_THROWS(neo::http::read_response_head_into(neo::mutable_buffer(storage.data(), 16),
+                                                    neo::pathological_buffer_range(res_str)));
+}
+
+TEST_CASE("Write a response") {
+    neo::http::headers hds;
+    hds.add("Content-Length", "5");
+    neo::http::status_line line;
+    line.http_version = neo::http::version::v1_1;
+    line.status       = 200;
+    line.phrase_view  = "Okay";
+
+    neo::string_dynbuf_io out;
+    auto n_written = neo::http::write_response(out, line, hds, neo::const_buffer("Hello"));
+    CHECK(out.read_area_view()
+          == "HTTP/1.1 200 Okay\r\n"
+             "Content-Length: 5\r\n"
+             "\r\n"
+             "Hello");
+    CHECK(n_written == out.read_area_view().size());
+}
+
+TEST_CASE("Write a response with a default phrase") {
+    neo::http::headers    hds;
+    neo::string_dynbuf_io out;
+    neo::http::write_response(out, neo::http::version::v1_0, 404, hds, neo::const_buffer());
+    CHECK(out.read_area_view() == "HTTP/1.0 404 Not Found\r\n\r\n");
+}
+
+TEST_CASE("Pull a response body from the input") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 200 Okay\r\n"
+        "Content-Length: 12\r\n"
+        "\r\n"
+        "Message bodyNext message");
+    neo::buffers_consumer in{res_str};
+
+    auto [head, body] = neo::http::read_response_head_and_body(in);
+    CHECK(head.status == 200);
+    CHECK(body.kind() == decltype(body)::kind_t::length);
+    CHECK(body.remaining() == 12u);
+
+    neo::const_buffer part = body.next(1024);
+    CHECK(std::string_view(part) == "Message body");
+    // The body is a view of the input, not a copy
+    CHECK(part.data() == res_str.data() + head.head_byte_size);
+    body.consume(8);
+    CHECK(std::string_view(neo::const_buffer(body.next(1024))) == "body");
+    body.consume(4);
+    CHECK(body.done());
+    CHECK(neo::const_buffer(body.next(1024)).empty());
+    CHECK(std::string_view(neo::const_buffer(in.next(1024))) == "Next message");
+}
+
+TEST_CASE("Pull a chunked response body from the input") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.1 200 Okay\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "4\r\nMess\r\n"
+        "8\r\nage body\r\n"
+        "0\r\nChecksum: 42\r\n\r\n");
+    neo::buffers_consumer in{res_str};
+
+    auto res = neo::http::read_response_head_and_body(in);
+    CHECK(res.body.kind() == decltype(res.body)::kind_t::chunked);
+    neo::string_dynbuf_io out;
+    neo::buffer_copy(out, res.body);
+    CHECK(out.read_area_view() == "Message body");
+    CHECK(res.body.done());
+    CHECK(std::string_view(res.body.chunked().trailer_bytes()) == "Checksum: 42\r\n");
+}
+
+TEST_CASE("Response bodies without framing") {
+    auto res_str = neo::const_buffer(
+        "HTTP/1.0 200 Okay\r\n"
+        "\r\n"
+        "Everything until close");
+    neo::buffers_consumer in{res_str};
+    auto                  res = neo::http::read_response_head_and_body(in);
+    CHECK(res.body.kind() == decltype(res.body)::kind_t::until_close);
+    neo::string_dynbuf_io out;
+    neo::buffer_copy(out, res.body);
+    CHECK(out.read_area_view() == "Everything until close");
+
+    auto no_content = neo::const_buffer(
+        "HTTP/1.1 204 No Content\r\n"
+        "\r\n"
+        "HTTP/1.1 200 Okay\r\n");
+    neo::buffers_consumer in2{no_content};
+    auto                  res2 = neo::http::read_response_head_and_body(in2);
+    CHECK(res2.body.done());
+    CHECK(neo::const_buffer(res2.body.next(1024)).empty());
+}
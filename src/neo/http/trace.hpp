@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+ * Static tracepoints (USDT probes) for following individual messages with tools like `perf probe`
+ * and `bpftrace`. The probes are compiled out unless NEO_HTTP_USDT is defined to 1 and
+ * <sys/sdt.h> is available (from SystemTap's development package). A disabled probe that has been
+ * compiled in costs a single no-op instruction.
+ *
+ * All probes belong to the provider `neo_http`:
+ *
+ *  - `head_start()`: A head reader has started looking for a message head
+ *  - `head_done(head_size)`: A message head of `head_size` bytes has been parsed
+ *  - `framing(has_content_length, content_length, chunked)`: The framing of a message body was
+ *    decided from its head
+ *  - `chunk_head(chunk_size)`: A chunked body decoder found the head of a chunk. The last chunk
+ *    has a size of zero.
+ *  - `chunked_done(trailer_size)`: A chunked body decoder read the end of the body.
+ *    A chunk_span_decoder that skips the trailer fields itself always gives a size of zero.
+ *  - `body_done(body_size)`: A body was copied or forwarded to its destination
+ *
+ * For example, to print the size of every chunk read by a program:
+ *
+ *     bpftrace -e 'usdt:./prog:neo_http:chunk_head { printf("%d\n", arg0); }'
+ */
+
+#if !defined(NEO_HTTP_USDT)
+#define NEO_HTTP_USDT 0
+#endif
+
+#if NEO_HTTP_USDT && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define NEO_HTTP_HAVE_USDT 1
+#endif
+#endif
+
+#if defined(NEO_HTTP_HAVE_USDT)
+#define NEO_HTTP_PROBE0(name) DTRACE_PROBE(neo_http, name)
+#define NEO_HTTP_PROBE1(name, a) DTRACE_PROBE1(neo_http, name, a)
+#define NEO_HTTP_PROBE2(name, a, b) DTRACE_PROBE2(neo_http, name, a, b)
+#define NEO_HTTP_PROBE3(name, a, b, c) DTRACE_PROBE3(neo_http, name, a, b, c)
+#else
+#define NEO_HTTP_PROBE0(name) ((void)0)
+#define NEO_HTTP_PROBE1(name, a) ((void)0)
+#define NEO_HTTP_PROBE2(name, a, b) ((void)0)
+#define NEO_HTTP_PROBE3(name, a, b, c) ((void)0)
+#endif